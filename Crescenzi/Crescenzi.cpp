@@ -1,81 +1,92 @@
 // crescenzi_ifub.cpp
 #include <bits/stdc++.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
 using namespace std;
 using Clock = chrono::high_resolution_clock;
 
-// ——— Graph definition and loader ———
-using Edge = tuple<int,int,double>;
-struct Graph {
-    int n;
-    vector<vector<Edge>> adj;
-    bool weighted = false;
-    Graph(int _n): n(_n), adj(n) {}
-    void add_edge(int u,int v,double w=1.0){
-        adj[u].emplace_back(u,v,w);
-        adj[v].emplace_back(v,u,w);
-        if(w!=1.0) weighted = true;
-    }
-};
+#include "../common/graph_io.hpp"
+#include "../common/trace.hpp"
+#include "../common/parallel_bfs.hpp"
+#include "../common/landmarks.hpp"
 
-Graph load_mm_graph(const string& path){
-    ifstream in(path);
-    if(!in) throw runtime_error("Cannot open "+path);
-    string header; 
-    getline(in, header);
-    if(header.rfind("%%MatrixMarket",0)!=0)
-        throw runtime_error("Not a MatrixMarket file");
-    
+// ——— Narrow-width BFS ———
+// Small-world and mesh diameters fit in a byte, so the sequential BFS keeps
+// distances as uint8 (sentinel 255 = unreached) and only widens to uint16,
+// then int, when a level would reach the sentinel. Widening converts the
+// array in place of the BFS, which continues from the same queue position.
+template<class To, class From>
+vector<To> widen(vector<From>& d){
+    vector<To> w(d.size());
+    for(size_t i = 0; i < d.size(); ++i)
+        w[i] = d[i] == numeric_limits<From>::max() ? numeric_limits<To>::max() : To(d[i]);
+    d = vector<From>();
+    return w;
+}
 
-    bool is_complex  = header.find("complex") != string::npos;
+// Continues a BFS on q[head..tail); false if the next level does not fit in D.
+template<class Graph, class D>
+bool bfs_levels(const Graph& G, vector<D>& dist, vector<int>& q, size_t& head, size_t& tail){
+    const D unreached = numeric_limits<D>::max();
+    while(head < tail){
+        int u = q[head];
+        if(dist[u] == unreached - 1) return false;
+        ++head;
+        for(auto [v,_w]: G.adj[u]){
+            if(dist[v] == unreached){
+                dist[v] = dist[u] + 1;
+                q[tail++] = v;
+            }
+        }
+    }
+    return true;
+}
 
-    bool is_weighted = header.find("real")!=string::npos
-                    || header.find("integer")!=string::npos;
-    string line;
-    while(getline(in,line) && line.size() && line[0]=='%');
-    istringstream iss(line);
-    int M,N,L; iss>>M>>N>>L;
-    if(M!=N) throw runtime_error("Only square graphs supported");
-    Graph G(M);
-    for(int i=0;i<L;i++){
-        int u,v; double w=1.0;
-        in>>u>>v;
-        if(is_weighted) in>>w;
-
-        else if(is_complex){
-            double wr, wi;
-            in >> wr >> wi;
-            w = wr;
-        }        
-        G.add_edge(u-1,v-1,w);
-    }
-    return G;
+// BFS from src in the narrowest distance type that fits; calls
+// done(dist, ecc) with the final array and returns its result.
+template<class Graph, class F>
+auto adaptive_bfs(const Graph& G, int src, F&& done){
+    vector<int> q(G.n);
+    size_t head = 0, tail = 0;
+    vector<uint8_t> d8(G.n, UINT8_MAX);
+    d8[src] = 0; q[tail++] = src;
+    if(bfs_levels(G, d8, q, head, tail)) return done(d8, int(d8[q[tail-1]]));
+    auto d16 = widen<uint16_t>(d8);
+    if(bfs_levels(G, d16, q, head, tail)) return done(d16, int(d16[q[tail-1]]));
+    auto d32 = widen<int>(d16);
+    bfs_levels(G, d32, q, head, tail);
+    return done(d32, d32[q[tail-1]]);
 }
 
 // ——— BFS eccentricity computation ———
+template<class Graph>
 int eccentricity(const Graph& G, int src){
-    vector<int> dist(G.n, INT_MAX);
-    queue<int> q;
-    dist[src] = 0; q.push(src);
-    int ecc = 0;
-    while(!q.empty()){
-        int u = q.front(); q.pop();
-        for(auto [_,v,_w]: G.adj[u]){
-            if(dist[v] == INT_MAX){
-                dist[v] = dist[u] + 1;
-                ecc = max(ecc, dist[v]);
-                q.push(v);
-            }
-        }
+    double ts = TRACE.enabled ? TRACE.now() : 0;
+    if(use_parallel_bfs(G)){
+        vector<int> dist;
+        int ecc = parallel_bfs(G, src, dist);
+        if(TRACE.enabled) TRACE.record_bfs(G, "ecc", src, dist, ts);
+        LANDMARKS.offer(src, dist);
+        return ecc;
     }
-    return ecc;
+    return adaptive_bfs(G, src, [&](const auto& dist, int ecc){
+        if(TRACE.enabled) TRACE.record_bfs(G, "ecc", src, dist, ts);
+        LANDMARKS.offer(src, dist);
+        return ecc;
+    });
 }
 
 // ——— Root selection strategies ———
-int random_root(int n) {
-    return rand() % n;
+// Every random choice draws from an explicit generator, so a run is fixed by
+// its seed and concurrent runs do not share state.
+int random_root(int n, mt19937& rng) {
+    return rng() % n;
 }
 
+template<class Graph>
 int highest_degree(const Graph& G) {
+    TraceScope trace("degree_scan");
     int max_deg = -1, best = 0;
     for(int i = 0; i < G.n; ++i){
         if((int)G.adj[i].size() > max_deg){
@@ -86,14 +97,17 @@ int highest_degree(const Graph& G) {
     return best;
 }
 
+template<class Graph>
 int four_sweep(const Graph& G, int initial){
+    TraceScope trace("four_sweep");
     auto bfs_far = [&](int src) {
+        double ts = TRACE.enabled ? TRACE.now() : 0;
         vector<int> dist(G.n, INT_MAX);
         queue<int> q; dist[src] = 0; q.push(src);
         int far = src;
         while(!q.empty()){
             int u = q.front(); q.pop();
-            for(auto [_,v,_w]: G.adj[u]){
+            for(auto [v,_w]: G.adj[u]){
                 if(dist[v] == INT_MAX){
                     dist[v] = dist[u] + 1;
                     if(dist[v] > dist[far]) far = v;
@@ -101,6 +115,8 @@ int four_sweep(const Graph& G, int initial){
                 }
             }
         }
+        if(TRACE.enabled) TRACE.record_bfs(G, "sweep", src, dist, ts);
+        LANDMARKS.offer(src, dist);
         return far;
     };
     int a1 = bfs_far(initial);
@@ -110,79 +126,715 @@ int four_sweep(const Graph& G, int initial){
     return a2; // midpoint not needed for iFUB start
 }
 
-// ——— iFUB ———
-int iFUB(const Graph& G, int root, int& bfsCount){
-    vector<int> dist(G.n, INT_MAX);
-    queue<int> q; dist[root] = 0; q.push(root);
-    vector<vector<int>> levels(G.n);
-    levels[0].push_back(root);
-    int D = 0;
-    while(!q.empty()){
-        int u = q.front(); q.pop();
-        for(auto [_,v,_w]: G.adj[u]){
+// ——— Multi-start sweep root selection ———
+// Several 4-sweeps run concurrently from different seeds. Each one yields
+// eccentricities (lower bounds on the diameter) and a midpoint of a long
+// shortest path; the midpoint with the smallest eccentricity becomes the
+// iFUB root, and its BFS plus every eccentricity already computed is handed
+// to iFUB instead of being recomputed.
+struct SweepResult {
+    int root = -1;                   // most central midpoint found
+    int lb = 0;                      // largest eccentricity seen
+    vector<int> rootDist;            // BFS distances from root
+    unordered_map<int,int> knownEcc; // vertex -> exact eccentricity
+    vector<int> farEnds;             // far ends of the last sweeps
+    int bfsCalls = 0;
+};
+
+// BFS from src into dist; returns the eccentricity and the farthest vertex.
+template<class Graph>
+int bfs_dist(const Graph& G, int src, vector<int>& dist, int& far){
+    double ts = TRACE.enabled ? TRACE.now() : 0;
+    dist.assign(G.n, INT_MAX);
+    vector<int> q(G.n);
+    size_t head = 0, tail = 0;
+    dist[src] = 0; q[tail++] = src;
+    far = src;
+    while(head < tail){
+        int u = q[head++];
+        for(auto [v,_w]: G.adj[u]){
             if(dist[v] == INT_MAX){
                 dist[v] = dist[u] + 1;
-                D = max(D, dist[v]);
-                levels[dist[v]].push_back(v);
-                q.push(v);
+                far = v;
+                q[tail++] = v;
             }
         }
     }
+    if(TRACE.enabled) TRACE.record_bfs(G, "sweep", src, dist, ts);
+    LANDMARKS.offer(src, dist);
+    return dist[far];
+}
+
+// Vertex halfway along a shortest path from the BFS source to b.
+template<class Graph>
+int path_midpoint(const Graph& G, const vector<int>& dist, int b){
+    int v = b;
+    for(int steps = dist[b] - dist[b] / 2; steps > 0; --steps){
+        for(auto [w,_w]: G.adj[v]){
+            if(dist[w] == dist[v] - 1){ v = w; break; }
+        }
+    }
+    return v;
+}
+
+struct SingleSweep {
+    int lb = 0, mid = -1, midEcc = INT_MAX, farEnd = -1;
+    vector<int> midDist;
+    vector<pair<int,int>> ecc;
+};
+
+// 4-sweep from seed: seed -> a1 -> (b1, midpoint m1) -> a2 -> (b2, midpoint m2),
+// followed by a BFS from m2 to learn how central it is.
+template<class Graph>
+SingleSweep run_four_sweep(const Graph& G, int seed){
+    SingleSweep S;
+    vector<int> dist;
+    int far;
+    auto visit = [&](int src, vector<int>& d){
+        int e = bfs_dist(G, src, d, far);
+        S.ecc.emplace_back(src, e);
+        S.lb = max(S.lb, e);
+        return far;
+    };
+    int a1 = visit(seed, dist);
+    int b1 = visit(a1, dist);
+    int m1 = path_midpoint(G, dist, b1);
+    int a2 = visit(m1, dist);
+    int b2 = visit(a2, dist);
+    S.mid = path_midpoint(G, dist, b2);
+    S.farEnd = b2;
+    visit(S.mid, S.midDist);
+    S.midEcc = S.ecc.back().second;
+    return S;
+}
+
+// Runs the sweeps of one round on up to `threads` threads and folds them into R.
+template<class Graph>
+void sweep_round(const Graph& G, const vector<int>& seeds, SweepResult& R, int threads){
+    vector<SingleSweep> out(seeds.size());
+    size_t workers = max(1, threads);
+    for(size_t base = 0; base < seeds.size(); base += workers){
+        vector<thread> pool;
+        for(size_t i = base; i < min(seeds.size(), base + workers); ++i)
+            pool.emplace_back([&, i]{ out[i] = run_four_sweep(G, seeds[i]); });
+        for(auto& t : pool) t.join();
+    }
+    R.farEnds.clear();
+    for(auto& S : out){
+        R.bfsCalls += S.ecc.size();
+        R.lb = max(R.lb, S.lb);
+        for(auto [v, e] : S.ecc) R.knownEcc[v] = e;
+        R.farEnds.push_back(S.farEnd);
+        if(R.root < 0 || S.midEcc < R.knownEcc[R.root]){
+            R.root = S.mid;
+            R.rootDist = move(S.midDist);
+        }
+    }
+}
+
+// Round 1 seeds: the top-degree vertices and random vertices; round 2 seeds:
+// the far ends reached in round 1 that have not been swept from yet.
+template<class Graph>
+SweepResult multi_sweep(const Graph& G, int k, mt19937& rng, int threads){
+    TraceScope trace("multi_sweep");
+    vector<int> byDeg(G.n);
+    iota(byDeg.begin(), byDeg.end(), 0);
+    int top = min(G.n, max(1, k / 2));
+    partial_sort(byDeg.begin(), byDeg.begin() + top, byDeg.end(),
+                 [&](int a, int b){ return G.adj[a].size() > G.adj[b].size(); });
+    vector<int> seeds(byDeg.begin(), byDeg.begin() + top);
+    while((int)seeds.size() < k) seeds.push_back(random_root(G.n, rng));
+
+    SweepResult R;
+    sweep_round(G, seeds, R, threads);
+    vector<int> next;
+    for(int v : R.farEnds)
+        if(!R.knownEcc.count(v) && find(next.begin(), next.end(), v) == next.end())
+            next.push_back(v);
+    if(!next.empty()) sweep_round(G, next, R, threads);
+    return R;
+}
+
+// Candidate roots written by take_kosters/hyperanf (--candidates): lines
+// "vertex,role,last_change" with 0-based vertices and role center or
+// periphery; '#' lines are comments.
+vector<pair<int,string>> load_candidates(const string& path, int n){
+    ifstream in(path);
+    if(!in) throw runtime_error("Cannot open "+path);
+    vector<pair<int,string>> out;
+    string line;
+    while(getline(in, line)){
+        if(line.empty() || line[0] == '#') continue;
+        istringstream iss(line);
+        string v, role;
+        getline(iss, v, ',');
+        getline(iss, role, ',');
+        int id = stoi(v);
+        if(id < 0 || id >= n) throw runtime_error("Candidate vertex out of range in "+path);
+        out.emplace_back(id, role);
+    }
+    return out;
+}
+
+// A root-selection strategy together with its per-run state: the RNG and,
+// for strategy 4, the sweep results iFUB reuses.
+struct RootSelector {
+    int strategy, sweeps;
+    mt19937 rng;
+    SweepResult sweep;
+    int fixedRoot = -1; // from --candidates; overrides the strategy
+    int sweepThreads = PAR_BFS.threads; // strategy 4's concurrent sweeps
+    RootSelector(int _strategy, int _sweeps, uint32_t seed)
+        : strategy(_strategy), sweeps(_sweeps), rng(seed) {}
+
+    // -1 for an unknown strategy code.
+    template<class Graph>
+    int select(const Graph& G){
+        TraceScope trace("root_selection");
+        if(fixedRoot >= 0) return fixedRoot;
+        switch(strategy){
+          case 0: return random_root(G.n, rng);
+          case 1: return highest_degree(G);
+          case 2: return four_sweep(G, random_root(G.n, rng));
+          case 3: return four_sweep(G, highest_degree(G));
+          case 4: sweep = multi_sweep(G, sweeps, rng, sweepThreads); return sweep.root;
+          default: return -1;
+        }
+    }
+    const SweepResult* reusable() const { return strategy == 4 && fixedRoot < 0 ? &sweep : nullptr; }
+};
+
+// ——— Checkpointing ———
+// iFUB() serialises its position every --checkpoint-every seconds and hands
+// the bytes to a writer thread, which writes path.tmp, fsyncs it and renames
+// it over path: the file on disk is always complete and the fringe loop never
+// waits for the disk. A newer snapshot replaces one still waiting to be written.
+struct ByteWriter {
+    vector<char> buf;
+    template<class T> void put(const T& x){
+        const char* p = (const char*)&x;
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+};
+
+struct ByteReader {
+    vector<char> buf;
+    size_t pos = 0;
+    ByteReader(const string& path){
+        ifstream in(path, ios::binary);
+        if(!in) throw runtime_error("Cannot open "+path);
+        buf.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    template<class T> T get(){
+        if(pos + sizeof(T) > buf.size()) throw runtime_error("Truncated checkpoint");
+        T x;
+        memcpy(&x, buf.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return x;
+    }
+};
+
+struct Checkpointer {
+    string path;
+    double every = 60;
+    Clock::time_point last = Clock::now();
+    mutex mu;
+    condition_variable cv;
+    vector<char> queued;
+    bool hasQueued = false, stop = false;
+    thread writer;
+    int written = 0;
+
+    bool enabled() const { return !path.empty(); }
+    void start(){
+        if(enabled()) writer = thread([this]{ loop(); });
+    }
+    bool due() const {
+        return enabled() && chrono::duration<double>(Clock::now() - last).count() >= every;
+    }
+    void submit(vector<char>&& buf){
+        last = Clock::now();
+        lock_guard<mutex> lk(mu);
+        queued = move(buf);
+        hasQueued = true;
+        cv.notify_one();
+    }
+    // Flushes the last queued snapshot and stops the writer.
+    void finish(){
+        if(!writer.joinable()) return;
+        { lock_guard<mutex> lk(mu); stop = true; }
+        cv.notify_one();
+        writer.join();
+    }
+    ~Checkpointer(){ finish(); }
+private:
+    void loop(){
+        unique_lock<mutex> lk(mu);
+        for(;;){
+            cv.wait(lk, [this]{ return hasQueued || stop; });
+            if(!hasQueued) return;
+            vector<char> buf = move(queued);
+            hasQueued = false;
+            lk.unlock();
+            write_atomic(buf);
+            lk.lock();
+        }
+    }
+    void write_atomic(const vector<char>& buf){
+        string tmp = path + ".tmp";
+        int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool ok = fd >= 0;
+        for(size_t off = 0; ok && off < buf.size(); ){
+            ssize_t k = ::write(fd, buf.data() + off, buf.size() - off);
+            if(k <= 0) ok = false;
+            else off += k;
+        }
+        ok = ok && fsync(fd) == 0;
+        if(fd >= 0) close(fd);
+        if(ok && rename(tmp.c_str(), path.c_str()) == 0) ++written;
+        else cerr<<"Checkpoint write to "<<path<<" failed\n";
+    }
+};
+Checkpointer CKPT;
+
+// Position of a running iFUB() plus what is needed to pick the same root
+// again. On resume the root is re-selected with the saved strategy and seed
+// and its BFS and level layout are recomputed; (d, i) is the next fringe
+// vertex to process.
+struct IfubProgress {
+    int n = 0, strategy = 0, sweeps = 0, fixedRoot = -1;
+    uint32_t seed = 0;
+    int root = -1, d = -1, i = 0, lb = 0, ub = 0, bfsCount = 0;
+    double seconds = 0;
+
+    static constexpr uint32_t VERSION = 1;
+    vector<char> save() const {
+        ByteWriter w;
+        w.buf.insert(w.buf.end(), {'I','F','C','K'});
+        w.put(VERSION);
+        for(int x : {n, strategy, sweeps, fixedRoot}) w.put(x);
+        w.put(seed);
+        for(int x : {root, d, i, lb, ub, bfsCount}) w.put(x);
+        w.put(seconds);
+        return move(w.buf);
+    }
+    void load(const string& path){
+        ByteReader r(path);
+        if(r.buf.size() < 4 || memcmp(r.buf.data(), "IFCK", 4) != 0)
+            throw runtime_error("Not an iFUB checkpoint");
+        r.pos = 4;
+        if(r.get<uint32_t>() != VERSION) throw runtime_error("Unsupported checkpoint version");
+        for(int* x : {&n, &strategy, &sweeps, &fixedRoot}) *x = r.get<int>();
+        seed = r.get<uint32_t>();
+        for(int* x : {&root, &d, &i, &lb, &ub, &bfsCount}) *x = r.get<int>();
+        seconds = r.get<double>();
+    }
+};
+
+// ——— iFUB ———
+// Flat level layout: counting-sort the reached vertices by root distance,
+// so level d is levels[levelStart[d] .. levelStart[d+1]).
+template<class Dist>
+void flat_levels(const Dist& dist, int D, vector<int>& levelStart, vector<int>& levels){
+    const auto unreached = numeric_limits<typename Dist::value_type>::max();
+    levelStart.assign(D + 2, 0);
+    for(size_t v = 0; v < dist.size(); ++v)
+        if(dist[v] != unreached) levelStart[dist[v] + 1]++;
+    for(int d = 0; d <= D; ++d) levelStart[d + 1] += levelStart[d];
+    levels.resize(levelStart[D + 1]);
+    vector<int> pos(levelStart.begin(), levelStart.end() - 1);
+    for(size_t v = 0; v < dist.size(); ++v)
+        if(dist[v] != unreached) levels[pos[dist[v]]++] = v;
+}
+
+// With a SweepResult the root BFS is reused and known eccentricities skip
+// their BFS; bfsCount then only counts BFS runs made here. With an
+// IfubProgress the position is checkpointed as the loop goes, and a progress
+// with d >= 0 resumes from it.
+template<class Graph>
+int iFUB(const Graph& G, int root, int& bfsCount, const SweepResult* sweep = nullptr,
+         IfubProgress* prog = nullptr){
+    double ts = TRACE.enabled ? TRACE.now() : 0;
+    auto t0 = Clock::now();
+    double baseSeconds = prog ? prog->seconds : 0;
+    vector<int> levelStart, levels;
+    auto layout = [&](const auto& dist, int ecc){
+        flat_levels(dist, ecc, levelStart, levels);
+        if(TRACE.enabled) TRACE.record_bfs(G, "root", root, dist, ts);
+        LANDMARKS.offer(root, dist);
+        return ecc;
+    };
+    int D = 0;
+    if(sweep){
+        for(int x : sweep->rootDist) if(x != INT_MAX) D = max(D, x);
+        layout(sweep->rootDist, D);
+    } else if(use_parallel_bfs(G)){
+        vector<int> dist;
+        D = layout(dist, parallel_bfs(G, root, dist));
+    } else {
+        D = adaptive_bfs(G, root, layout);
+    }
+    if(TRACE.enabled) TRACE.phase("level_construction", ts, TRACE.now() - ts);
 
     int lb = D, ub = 2*D; // initial bounds
     bfsCount = 1;
+    if(sweep){
+        lb = max(lb, sweep->lb);
+        bfsCount = 0;
+    }
+
+    int dStart = D, iStart = -1;
+    if(prog && prog->d >= 0){
+        if(prog->d > D) throw runtime_error("Checkpoint does not match the root BFS");
+        lb = prog->lb; ub = prog->ub; bfsCount = prog->bfsCount;
+        dStart = prog->d; iStart = prog->i;
+    }
 
-    for(int d = D; d >= (ub+1)/2; --d){
-        for(int v : levels[d]){
-            int ecc = eccentricity(G, v);
+    TraceScope trace("fringe_bfs");
+    for(int d = dStart; d > 0 && lb < ub; --d){
+        int first = d == dStart && iStart >= 0 ? iStart : levelStart[d];
+        for(int i = first; i < levelStart[d + 1]; ++i){
+            int v = levels[i];
+            int ecc;
+            if(sweep && sweep->knownEcc.count(v)) ecc = sweep->knownEcc.at(v);
+            else { ecc = eccentricity(G, v); bfsCount++; }
             lb = max(lb, ecc);
-            ub = min(ub, 2 * ecc);
-            bfsCount++;
+            if(TRACE.enabled)
+                TRACE.counter("bounds", "\"lb\":" + to_string(lb) + ",\"ub\":" + to_string(ub));
             if(lb == ub) return lb;
+            if(prog && CKPT.due()){
+                prog->d = d; prog->i = i + 1;
+                prog->lb = lb; prog->ub = ub; prog->bfsCount = bfsCount;
+                prog->seconds = baseSeconds + chrono::duration<double>(Clock::now() - t0).count();
+                CKPT.submit(prog->save());
+            }
         }
+        // every vertex above level d-1 is done; pairs below are within 2(d-1)
+        ub = max(lb, 2 * (d - 1));
     }
-    return lb; // exact if lb==ub
+    return lb;
 }
 
-// ——— main() ———
-int main(int argc, char* argv[]){
-    if(argc < 3){
-        cerr << "Usage: " << argv[0] << " [strategy: 0=random, 1=hd, 2=4s-rand, 3=4s-hd] graph.mtx\n";
-        return 1;
+// ——— Weighted iFUB ———
+// Same fringe argument as iFUB() with Dijkstra distances: once every vertex
+// farther than r from the root has been processed, any remaining pair is
+// within 2r of each other, so the diameter is at most max(lb, 2r). Vertices
+// are grouped into buckets of equal root distance and processed from the
+// farthest bucket inwards.
+template<class Graph>
+double weighted_eccentricity(const Graph& G, int src, vector<double>& dist){
+    using P = pair<double,int>;
+    dist.assign(G.n, numeric_limits<double>::infinity());
+    priority_queue<P, vector<P>, greater<P>> pq;
+    dist[src] = 0; pq.emplace(0.0, src);
+    double ecc = 0;
+    while(!pq.empty()){
+        auto [du, u] = pq.top(); pq.pop();
+        if(du > dist[u]) continue;
+        ecc = max(ecc, du);
+        for(auto [v,w]: G.adj[u]){
+            if(du + w < dist[v]){
+                dist[v] = du + w;
+                pq.emplace(dist[v], v);
+            }
+        }
     }
-    int strategy = stoi(argv[1]);
-    printf("start");
-    Graph G = load_mm_graph(argv[2]);
-    printf("DOne");
-    srand(time(0));
+    return ecc;
+}
 
-    int start_node;
-    if(strategy == 0) start_node = random_root(G.n);
-    else if(strategy == 1) start_node = highest_degree(G);
-    else if(strategy == 2) start_node = four_sweep(G, random_root(G.n));
-    else if(strategy == 3) start_node = four_sweep(G, highest_degree(G));
-    else { cerr << "Invalid strategy code\n"; return 1; }
+template<class Graph>
+double weighted_iFUB(const Graph& G, int root, int& sspCount){
+    for(auto& nbrs : G.adj)
+        for(auto [v,w]: nbrs)
+            if(w < 0) throw runtime_error("Weighted iFUB needs non-negative weights");
 
-    int bfsCalls = 0;
-    auto t0 = Clock::now();
-    int diam = iFUB(G, start_node, bfsCalls);
-    auto t1 = Clock::now();
+    vector<double> dist;
+    double rootEcc;
+    vector<int> order;
+    {
+        TraceScope trace("level_construction");
+        rootEcc = weighted_eccentricity(G, root, dist);
+        for(int v = 0; v < G.n; ++v)
+            if(dist[v] != numeric_limits<double>::infinity()) order.push_back(v);
+        sort(order.begin(), order.end(), [&](int a, int b){ return dist[a] > dist[b]; });
+    }
 
-    double seconds = chrono::duration<double>(t1 - t0).count();
+    double lb = rootEcc, ub = 2 * rootEcc;
+    sspCount = 1;
+    vector<double> scratch;
+    TraceScope trace("fringe_sssp");
+    for(size_t i = 0; i < order.size(); ){
+        double r = dist[order[i]];
+        ub = max(lb, 2 * r);
+        if(TRACE.enabled)
+            TRACE.counter("bounds", "\"lb\":" + to_string(lb) + ",\"ub\":" + to_string(ub));
+        if(lb >= ub) break;
+        // one distance bucket
+        for(; i < order.size() && dist[order[i]] == r; ++i){
+            lb = max(lb, weighted_eccentricity(G, order[i], scratch));
+            sspCount++;
+        }
+    }
+    return lb;
+}
 
+// ——— main() ———
+struct RunConfig {
+    int strategy = 0, sweeps = 2, trials = 0;
+    uint32_t seed = 0;
+    string tracePath;
+    int candidateRoot = -1;
+    bool resume = false;
+    IfubProgress progress; // --resume: where the interrupted run stopped
+};
+
+struct TrialResult {
+    int root = -1, bfsCalls = 0;
+    double diam = 0, seconds = 0;
+};
+
+// A resumed trial's time includes the time spent before the interruption.
+template<class Graph>
+TrialResult run_trial(const Graph& G, RootSelector& sel, IfubProgress* prog = nullptr){
+    TrialResult r;
+    r.root = sel.select(G);
+    double baseSeconds = 0;
+    if(prog){
+        if(prog->d >= 0 && prog->root != r.root)
+            throw runtime_error("Resumed root selection picked a different root");
+        prog->root = r.root;
+        baseSeconds = prog->seconds;
+    }
+    // Sweep lower bounds are hop counts, so weighted runs only take its root.
+    auto t0 = Clock::now();
+    if constexpr(Graph::weighted) r.diam = weighted_iFUB(G, r.root, r.bfsCalls);
+    else r.diam = iFUB(G, r.root, r.bfsCalls, sel.reusable(), prog);
+    r.seconds = baseSeconds + chrono::duration<double>(Clock::now() - t0).count();
+    return r;
+}
+
+long peak_rss_kb(){
     // grab memory usage
     struct rusage usage;
     getrusage(RUSAGE_SELF, &usage);
     // ru_maxrss is in kilobytes on Linux, bytes on macOS
-    long peak_rss = usage.ru_maxrss;
+    return usage.ru_maxrss;
+}
+
+// Trial i uses seed C.seed + i, so results do not depend on which worker ran
+// it. Up to --threads trials run at once on the shared graph; their BFS runs
+// stay sequential and strategy 4 splits the remaining threads between them,
+// so the workers do not oversubscribe the cores, and times are measured under
+// that contention.
+template<class Graph>
+void run_trials(const Graph& G, const RunConfig& C){
+    vector<TrialResult> res(C.trials);
+    atomic<int> next{0};
+    long long threshold = PAR_BFS.threshold;
+    PAR_BFS.threshold = LLONG_MAX;
+    int workers = min(C.trials, PAR_BFS.threads);
+    vector<thread> pool;
+    for(int w = 0; w < workers; ++w)
+        pool.emplace_back([&]{
+            for(int i; (i = next.fetch_add(1)) < C.trials; ){
+                RootSelector sel(C.strategy, C.sweeps, C.seed + i);
+                sel.fixedRoot = C.candidateRoot;
+                sel.sweepThreads = max(1, PAR_BFS.threads / workers);
+                res[i] = run_trial(G, sel);
+            }
+        });
+    for(auto& t : pool) t.join();
+    PAR_BFS.threshold = threshold;
+
+    auto mean_var = [&](auto field){
+        double mean = 0, var = 0;
+        for(auto& r : res) mean += field(r);
+        mean /= res.size();
+        for(auto& r : res) var += (field(r) - mean) * (field(r) - mean);
+        if(res.size() > 1) var /= res.size() - 1;
+        return make_pair(mean, var);
+    };
+    auto [callMean, callVar] = mean_var([](const TrialResult& r){ return double(r.bfsCalls); });
+    auto [timeMean, timeVar] = mean_var([](const TrialResult& r){ return r.seconds; });
+
+    cout << "Strategy:" << C.strategy << "\n"
+         << "Seed:" << C.seed << "\n"
+         << "Trials:" << C.trials << "\n"
+         << "# trial,seed,root,diameter,bfs_calls,time_s\n";
+    for(int i = 0; i < C.trials; ++i)
+        cout << i << "," << C.seed + i << "," << res[i].root << "," << res[i].diam
+             << "," << res[i].bfsCalls << "," << res[i].seconds << "\n";
+    cout << "Diameter:" << res[0].diam << "\n"
+         << "BFS_Calls_Mean:" << callMean << "\n"
+         << "BFS_Calls_Var:" << callVar << "\n"
+         << "Time_Mean(s):" << timeMean << "\n"
+         << "Time_Var:" << timeVar << "\n"
+         << "Peak_RSS:    " << peak_rss_kb() << " KB\n";
+}
+
+template<class Graph>
+void run_single(const Graph& G, const RunConfig& C){
+    RootSelector sel(C.strategy, C.sweeps, C.seed);
+    sel.fixedRoot = C.candidateRoot;
+    IfubProgress prog = C.progress;
+    if(!C.resume){
+        prog.n = G.n; prog.strategy = C.strategy; prog.sweeps = C.sweeps;
+        prog.fixedRoot = C.candidateRoot; prog.seed = C.seed;
+    }
+    CKPT.start();
+    TrialResult r = run_trial(G, sel, CKPT.enabled() || C.resume ? &prog : nullptr);
+    CKPT.finish();
+    long peak_rss = peak_rss_kb();
 
-    cout << "Strategy:" << strategy  << "\n"
-         << "Diameter:" << diam  << "\n"
-         << "BFS_Calls:" << bfsCalls  << "\n"
-         << "Time(s):" << seconds << "\n"
+    cout << "Strategy:" << C.strategy  << "\n"
+         << "Seed:" << C.seed << "\n"
+         << "Root:" << r.root << "\n"
+         << "Diameter:" << r.diam  << "\n"
+         << "BFS_Calls:" << r.bfsCalls  << "\n";
+    if(sel.reusable())
+        cout << "Sweep_BFS_Calls:" << sel.sweep.bfsCalls << "\n"
+             << "Sweep_Lower_Bound:" << sel.sweep.lb << "\n";
+    cout
+         << "Time(s):" << r.seconds << "\n"
          << "Peak_RSS:    " << peak_rss
                   << (sizeof(peak_rss)==sizeof(long)? " KB":" bytes")
          << "\n";
+}
 
+template<class Graph>
+int run(const Graph& G, RunConfig C, const string& candidatesPath){
+    // the first centre candidate becomes the root for every trial
+    if(!candidatesPath.empty())
+        for(auto& [v, role] : load_candidates(candidatesPath, G.n))
+            if(role == "center"){ C.candidateRoot = v; break; }
+    if(CKPT.enabled() || C.resume){
+        if(Graph::weighted || C.trials > 0)
+            throw runtime_error("--checkpoint/--resume apply to single unweighted iFUB runs");
+        if(C.resume && C.progress.n != G.n)
+            throw runtime_error("Checkpoint was written for a different graph");
+    }
+    if(LANDMARKS.enabled() && Graph::weighted)
+        throw runtime_error("--landmarks needs an unweighted graph");
+    if(C.trials > 0) run_trials(G, C);
+    else run_single(G, C);
+    if(LANDMARKS.enabled()){
+        LANDMARKS.write(G.n);
+        cerr << "# landmarks: " << LANDMARKS.kept.size() << " written to " << LANDMARKS.path << "\n";
+    }
+    if(TRACE.enabled){
+        TRACE.write_json(C.tracePath);
+        TRACE.print_summary(cerr);
+    }
     return 0;
 }
+
+#ifdef DIAMETER_LIB
+// ——— C API for take_kosters/diameter.py (-DDIAMETER_LIB -shared -fPIC) ———
+// The graph stays loaded between calls. Errors return null/-1 and set
+// ifub_error(). Calls are serialised, since the BFS configuration is global.
+using AnyGraph = variant<monostate, BasicGraph<void>, BasicGraph<uint32_t>,
+                         BasicGraph<float>, BasicGraph<double>>;
+struct IfubGraph { AnyGraph g; int n = 0; int64_t arcs = 0; bool weighted = false; };
+mutex API_MU;
+thread_local string API_ERROR;
+
+extern "C" {
+const char* ifub_error(){ return API_ERROR.c_str(); }
+
+void* ifub_load(const char* path){
+    lock_guard<mutex> lk(API_MU);
+    try {
+        auto* h = new IfubGraph;
+        with_graph(path, [&](auto&& G){
+            h->n = G.n;
+            h->weighted = G.weighted;
+            for(auto& nbr : G.adj) h->arcs += nbr.size();
+            h->g = move(G);
+            return 0;
+        });
+        return h;
+    } catch(const exception& e){
+        API_ERROR = e.what();
+        return nullptr;
+    }
+}
+void ifub_free_graph(void* g){ delete (IfubGraph*)g; }
+int ifub_vertices(void* g){ return ((IfubGraph*)g)->n; }
+long long ifub_arcs(void* g){ return ((IfubGraph*)g)->arcs; }
+int ifub_weighted(void* g){ return ((IfubGraph*)g)->weighted; }
+
+// One run as `cresc strategy graph --seed seed --sweeps sweeps` (sweeps <= 0:
+// the default). out receives diameter, root, BFS calls and seconds.
+int ifub_run(void* g, int strategy, uint32_t seed, int sweeps, double* out){
+    lock_guard<mutex> lk(API_MU);
+    try {
+        if(strategy < 0 || strategy > 4) throw runtime_error("Invalid strategy code");
+        if(sweeps <= 0) sweeps = max(2u, thread::hardware_concurrency());
+        visit([&](auto& G){
+            if constexpr(!is_same_v<decay_t<decltype(G)>, monostate>){
+                RootSelector sel(strategy, sweeps, seed);
+                TrialResult r = run_trial(G, sel);
+                out[0] = r.diam;
+                out[1] = r.root;
+                out[2] = r.bfsCalls;
+                out[3] = r.seconds;
+            }
+        }, ((IfubGraph*)g)->g);
+        return 0;
+    } catch(const exception& e){
+        API_ERROR = e.what();
+        return -1;
+    }
+}
+}
+#else
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        cerr << "Usage: " << argv[0] << " [strategy: 0=random, 1=hd, 2=4s-rand, 3=4s-hd, 4=multi-sweep] graph.mtx"
+             << " [--trace trace.json] [--sweeps k] [--threads T] [--par-bfs min_vertices]"
+             << " [--seed S] [--trials N] [--candidates hyperanf.csv]"
+             << " [--checkpoint file [--checkpoint-every seconds]] [--resume file]"
+             << " [--landmarks file [--landmark-count k]]\n";
+        return 1;
+    }
+    RunConfig C;
+    string candidatesPath;
+    C.sweeps = max(2u, thread::hardware_concurrency());
+    C.seed = time(0);
+    for(int i = 3; i + 1 < argc; i += 2){
+        string flag = argv[i];
+        if(flag == "--trace") C.tracePath = argv[i+1];
+        else if(flag == "--sweeps") C.sweeps = max(1, stoi(argv[i+1]));
+        else if(flag == "--threads") PAR_BFS.threads = BUILD.threads = max(1, stoi(argv[i+1]));
+        else if(flag == "--par-bfs") PAR_BFS.threshold = stoll(argv[i+1]);
+        else if(flag == "--seed") C.seed = stoul(argv[i+1]);
+        else if(flag == "--trials") C.trials = max(0, stoi(argv[i+1]));
+        else if(flag == "--candidates") candidatesPath = argv[i+1];
+        else if(flag == "--checkpoint") CKPT.path = argv[i+1];
+        else if(flag == "--checkpoint-every") CKPT.every = max(0.0, stod(argv[i+1]));
+        else if(flag == "--resume"){ C.resume = true; C.progress.load(argv[i+1]); }
+        else if(flag == "--landmarks") LANDMARKS.path = argv[i+1];
+        else if(flag == "--landmark-count") LANDMARKS.k = max(1, stoi(argv[i+1]));
+        else { cerr << "Unknown option " << flag << "\n"; return 1; }
+    }
+    TRACE.enabled = !C.tracePath.empty();
+
+    C.strategy = stoi(argv[1]);
+    if(C.strategy < 0 || C.strategy > 4){ cerr << "Invalid strategy code\n"; return 1; }
+    if(C.resume){
+        if(C.progress.strategy != C.strategy){ cerr << "Checkpoint was written for a different strategy\n"; return 1; }
+        C.seed = C.progress.seed;
+        C.sweeps = C.progress.sweeps;
+        candidatesPath.clear();
+        C.candidateRoot = C.progress.fixedRoot;
+    }
+    printf("start");
+    double ts = TRACE.now();
+    return with_graph(argv[2], [&](const auto& G){
+        if(TRACE.enabled) TRACE.phase("load", ts, TRACE.now() - ts);
+        printf("DOne");
+        BUILD.report(cerr);
+        return run(G, C, candidatesPath);
+    });
+}
+#endif
@@ -4,6 +4,8 @@ using namespace std;
 namespace fs = std::filesystem;
 using Clock = chrono::high_resolution_clock;
 
+#include "../common/graph_io.hpp"
+
 using Edge = tuple<int,int,double>;
 
 struct Graph {
@@ -18,35 +20,12 @@ struct Graph {
     }
 };
 
-Graph load_mm_graph(const string& path){
-    ifstream in(path);
-    if(!in) throw runtime_error("Cannot open " + path);
-    string header; getline(in, header);
-    if(header.rfind("%%MatrixMarket", 0) != 0)
-        throw runtime_error("Not a MatrixMarket file");
-    
-    bool is_complex  = header.find("complex") != string::npos;
-
-    bool is_weighted = header.find("real") != string::npos
-                    || header.find("integer") != string::npos;
-
-    string line;
-    while(getline(in,line) && line.size() && line[0] == '%');
-    istringstream iss(line);
-    int M, N, L; iss >> M >> N >> L;
-    if(M != N) throw runtime_error("Only square graphs supported");
-    Graph G(M);
-    for(int i = 0; i < L; i++){
-        int u, v; double w = 1.0;
-        in >> u >> v;
-        if(is_weighted) in >> w;
-        else if(is_complex){
-            double wr, wi;
-            in >> wr >> wi;
-            w = wr;
-        } 
-        G.add_edge(u-1, v-1, w);
-    }
+// Any format of common/graph_io.hpp: .mtx, .gbin (Generator/graph_gen), SNAP
+// edge lists and METIS graphs, optionally .gz/.zst-compressed.
+Graph load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    Graph G(E.n);
+    for(auto& [u,v,w] : E.edges) G.add_edge(u, v, w);
     return G;
 }
 
@@ -68,8 +47,8 @@ int eccentricity(const Graph& G, int src){
     return ecc;
 }
 
-int random_root(int n) {
-    return rand() % n;
+int random_root(int n, mt19937& rng) {
+    return rng() % n;
 }
 
 int highest_degree(const Graph& G) {
@@ -110,8 +89,6 @@ int four_sweep(const Graph& G, int initial){
 int iFUB(const Graph& G, int root, int& bfsCount){
     vector<int> dist(G.n, INT_MAX);
     queue<int> q; dist[root] = 0; q.push(root);
-    vector<vector<int>> levels(G.n);
-    levels[0].push_back(root);
     int D = 0;
     while(!q.empty()){
         int u = q.front(); q.pop();
@@ -119,82 +96,106 @@ int iFUB(const Graph& G, int root, int& bfsCount){
             if(dist[v] == INT_MAX){
                 dist[v] = dist[u] + 1;
                 D = max(D, dist[v]);
-                if (dist[v] < G.n)
-                    levels[dist[v]].push_back(v);
                 q.push(v);
             }
         }
     }
+    // Flat level layout: counting-sort the reached vertices by root distance,
+    // so level d is levels[levelStart[d] .. levelStart[d+1]).
+    vector<int> levelStart(D + 2, 0), levels;
+    for(int v = 0; v < G.n; ++v)
+        if(dist[v] != INT_MAX) levelStart[dist[v] + 1]++;
+    for(int d = 0; d <= D; ++d) levelStart[d + 1] += levelStart[d];
+    levels.resize(levelStart[D + 1]);
+    {
+        vector<int> pos(levelStart.begin(), levelStart.end() - 1);
+        for(int v = 0; v < G.n; ++v)
+            if(dist[v] != INT_MAX) levels[pos[dist[v]]++] = v;
+    }
 
     int lb = D, ub = 2 * D;
     bfsCount = 1;
 
-    for(int d = D; d >= (ub+1)/2; --d){
-        if (d >= (int)levels.size()) continue;
-        for(int v : levels[d]){
+    for(int d = D; d > 0 && lb < ub; --d){
+        for(int i = levelStart[d]; i < levelStart[d + 1]; ++i){
+            int v = levels[i];
             int ecc = eccentricity(G, v);
             lb = max(lb, ecc);
-            ub = min(ub, 2 * ecc);
             bfsCount++;
             if(lb == ub) return lb;
         }
+        // every vertex above level d-1 is done; pairs below are within 2(d-1)
+        ub = max(lb, 2 * (d - 1));
     }
     return lb;
 }
 
 int main(int argc, char* argv[]){
     if(argc < 3){
-        cerr << "Usage: " << argv[0] << " [strategy: 0=random, 1=hd, 2=4s-rand, 3=4s-hd] folder_path\n";
+        cerr << "Usage: " << argv[0] << " [strategy: 0=random, 1=hd, 2=4s-rand, 3=4s-hd] folder_path [seed]\n";
         return 1;
     }
 
     int strategy = stoi(argv[1]);
+    if(strategy < 0 || strategy > 3){ cerr << "Invalid strategy\n"; return 1; }
     string folder = argv[2];
-    srand(time(0));
+    uint32_t seed = argc > 3 ? stoul(argv[3]) : time(0);
+    mt19937 rng(seed);
     double totalTime = 0.0;
     int fileCount = 0;
 
+    vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(folder))
+        if (entry.path().extension() == ".mtx" || entry.path().extension() == ".gbin")
+            files.push_back(entry.path());
+
     cout << "File,Vertices,Edges,Diameter,BFS_Calls,Time(s)\n";
 
-    for (const auto& entry : fs::directory_iterator(folder)) {
-        
-        if (entry.path().extension() == ".mtx") {
-            try {
-                Graph G = load_mm_graph(entry.path());
-                if (G.n == 0) throw runtime_error("Graph has 0 nodes");
-
-                int start_node = 0;
-                if(strategy == 0) start_node = random_root(G.n);
-                else if(strategy == 1) start_node = highest_degree(G);
-                else if(strategy == 2) start_node = four_sweep(G, random_root(G.n));
-                else if(strategy == 3) start_node = four_sweep(G, highest_degree(G));
-                else { cerr << "Invalid strategy\n"; return 1; }
-
-                int bfsCalls = 0;
-                auto t0 = Clock::now();
-                int diam = iFUB(G, start_node, bfsCalls);
-                auto t1 = Clock::now();
-                double seconds = chrono::duration<double>(t1 - t0).count();
-
-                size_t edges = 0;
-                for (auto& nbrs : G.adj) edges += nbrs.size();
-                edges /= 2;
-
-                cout
-                << "File: "      << entry.path().filename()
-                << "   Vertices: " << G.n
-                << "   Edges: "    << edges
-                << "   Diameter: " << diam
-                << "   BFS Calls: "<< bfsCalls
-                << "   Time(s): "   << seconds
-                << "\n";
-
-                totalTime += seconds;
-                fileCount++;
-            }
-            catch(const exception& e){
-                cerr << "❌ Skipping " << entry.path().filename() << ": " << e.what() << "\n";
-            }
+    // One file of lookahead: the next graph is parsed on a helper thread while
+    // iFUB runs on the current one. iFUB itself still runs one graph at a
+    // time, so the per-file times are not shared with another computation.
+    auto prefetch = [&](size_t i){
+        return async(launch::async, [path = files[i]]{ return load_graph(path); });
+    };
+    future<Graph> next;
+    if (!files.empty()) next = prefetch(0);
+    for (size_t i = 0; i < files.size(); ++i) {
+        future<Graph> current = move(next);
+        if (i + 1 < files.size()) next = prefetch(i + 1);
+        try {
+            Graph G = current.get();
+            if (G.n == 0) throw runtime_error("Graph has 0 nodes");
+
+            int start_node = 0;
+            if(strategy == 0) start_node = random_root(G.n, rng);
+            else if(strategy == 1) start_node = highest_degree(G);
+            else if(strategy == 2) start_node = four_sweep(G, random_root(G.n, rng));
+            else start_node = four_sweep(G, highest_degree(G));
+
+            int bfsCalls = 0;
+            auto t0 = Clock::now();
+            int diam = iFUB(G, start_node, bfsCalls);
+            auto t1 = Clock::now();
+            double seconds = chrono::duration<double>(t1 - t0).count();
+
+            size_t edges = 0;
+            for (auto& nbrs : G.adj) edges += nbrs.size();
+            edges /= 2;
+
+            cout
+            << "File: "      << files[i].filename()
+            << "   Vertices: " << G.n
+            << "   Edges: "    << edges
+            << "   Diameter: " << diam
+            << "   BFS Calls: "<< bfsCalls
+            << "   Time(s): "   << seconds
+            << "\n";
+
+            totalTime += seconds;
+            fileCount++;
+        }
+        catch(const exception& e){
+            cerr << "❌ Skipping " << files[i].filename() << ": " << e.what() << "\n";
         }
     }
 
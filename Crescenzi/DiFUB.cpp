@@ -0,0 +1,291 @@
+// DiFUB.cpp
+// Directed diameter with DiFUB (Crescenzi et al.), the directed counterpart
+// of iFUB in Crescenzi.cpp. `general` MatrixMarket entries (i,j) are arcs
+// i->j; `symmetric` files and .gbin edge lists are read as arcs both ways.
+// A directed graph that is not strongly connected has infinite diameter, so
+// the diameter is computed on the largest strongly connected component.
+#include <bits/stdc++.h>
+#include <sys/resource.h>
+using namespace std;
+using Clock = chrono::high_resolution_clock;
+
+#include "../common/graph_io.hpp"
+
+// ——— Directed graph: forward and reverse CSR ———
+struct DiGraph {
+    int n = 0;
+    vector<int> outStart, outAdj; // arcs u -> outAdj[outStart[u] .. outStart[u+1])
+    vector<int> inStart,  inAdj;  // arcs inAdj[...] -> u
+
+    DiGraph() {}
+    DiGraph(int _n, const vector<pair<int,int>>& arcs): n(_n) {
+        build(arcs, outStart, outAdj, false);
+        build(arcs, inStart, inAdj, true);
+    }
+    void build(const vector<pair<int,int>>& arcs, vector<int>& start, vector<int>& adj, bool rev){
+        start.assign(n + 1, 0);
+        for(auto [u,v] : arcs) start[(rev ? v : u) + 1]++;
+        for(int i = 0; i < n; ++i) start[i + 1] += start[i];
+        adj.resize(arcs.size());
+        vector<int> pos(start.begin(), start.end() - 1);
+        for(auto [u,v] : arcs){
+            if(rev) adj[pos[v]++] = u;
+            else    adj[pos[u]++] = v;
+        }
+    }
+    int outDeg(int u) const { return outStart[u+1] - outStart[u]; }
+    int inDeg(int u)  const { return inStart[u+1] - inStart[u]; }
+};
+
+DiGraph load_mm_digraph(const string& path){
+    ifstream in(path);
+    if(!in) throw runtime_error("Cannot open "+path);
+    string header;
+    getline(in, header);
+    if(header.rfind("%%MatrixMarket",0)!=0)
+        throw runtime_error("Not a MatrixMarket file");
+    bool is_symmetric = header.find("symmetric") != string::npos
+                     || header.find("hermitian") != string::npos;
+    bool is_complex  = header.find("complex") != string::npos;
+    bool is_weighted = header.find("real")!=string::npos
+                    || header.find("integer")!=string::npos;
+    string line;
+    while(getline(in,line) && line.size() && line[0]=='%');
+    istringstream iss(line);
+    int M,N,L; iss>>M>>N>>L;
+    if(M!=N) throw runtime_error("Only square graphs supported");
+    vector<pair<int,int>> arcs;
+    arcs.reserve(is_symmetric ? 2 * (size_t)L : L);
+    for(int i=0;i<L;i++){
+        int u,v; double w;
+        in>>u>>v;
+        if(is_weighted) in>>w;
+        else if(is_complex) in>>w>>w;
+        if(u == v) continue;
+        arcs.emplace_back(u-1, v-1);
+        if(is_symmetric) arcs.emplace_back(v-1, u-1);
+    }
+    return DiGraph(M, arcs);
+}
+
+// .gbin edge lists (Generator/graph_gen) are undirected; they go through the
+// shared reader in common/graph_io.hpp.
+DiGraph load_gbin_digraph(const string& path){
+    EdgeList E = load_gbin_edges(path);
+    vector<pair<int,int>> arcs;
+    arcs.reserve(2 * E.edges.size());
+    for(auto& [u,v,w] : E.edges){
+        arcs.emplace_back(u, v);
+        arcs.emplace_back(v, u);
+    }
+    E.edges = {};
+    return DiGraph(E.n, arcs);
+}
+
+DiGraph load_digraph(const string& path){
+    if(path.size() >= 5 && path.substr(path.size()-5) == ".gbin") return load_gbin_digraph(path);
+    return load_mm_digraph(path);
+}
+
+// ——— Strongly connected components (iterative Kosaraju) ———
+// Returns the component id of every vertex and the number of components.
+int strongly_connected_components(const DiGraph& G, vector<int>& comp){
+    vector<int> order;
+    order.reserve(G.n);
+    vector<char> seen(G.n, 0);
+    vector<pair<int,int>> stack; // (vertex, next out-arc index)
+    for(int s = 0; s < G.n; ++s){
+        if(seen[s]) continue;
+        seen[s] = 1;
+        stack.emplace_back(s, G.outStart[s]);
+        while(!stack.empty()){
+            auto& [u, it] = stack.back();
+            if(it < G.outStart[u+1]){
+                int v = G.outAdj[it++];
+                if(!seen[v]){ seen[v] = 1; stack.emplace_back(v, G.outStart[v]); }
+            } else {
+                order.push_back(u);
+                stack.pop_back();
+            }
+        }
+    }
+    comp.assign(G.n, -1);
+    int c = 0;
+    vector<int> todo;
+    for(int i = G.n - 1; i >= 0; --i){
+        int s = order[i];
+        if(comp[s] >= 0) continue;
+        comp[s] = c;
+        todo.push_back(s);
+        while(!todo.empty()){
+            int u = todo.back(); todo.pop_back();
+            for(int k = G.inStart[u]; k < G.inStart[u+1]; ++k){
+                int v = G.inAdj[k];
+                if(comp[v] < 0){ comp[v] = c; todo.push_back(v); }
+            }
+        }
+        ++c;
+    }
+    return c;
+}
+
+// Subgraph induced by the vertices of component c, relabelled 0..k-1.
+DiGraph induced_component(const DiGraph& G, const vector<int>& comp, int c){
+    vector<int> id(G.n, -1);
+    int k = 0;
+    for(int v = 0; v < G.n; ++v) if(comp[v] == c) id[v] = k++;
+    vector<pair<int,int>> arcs;
+    for(int u = 0; u < G.n; ++u){
+        if(id[u] < 0) continue;
+        for(int i = G.outStart[u]; i < G.outStart[u+1]; ++i){
+            int v = G.outAdj[i];
+            if(id[v] >= 0) arcs.emplace_back(id[u], id[v]);
+        }
+    }
+    return DiGraph(k, arcs);
+}
+
+// ——— Forward / backward BFS ———
+// Forward: dist[v] = d(src, v). Backward: dist[v] = d(v, src).
+int directed_bfs(const DiGraph& G, int src, bool backward, vector<int>& dist){
+    const vector<int>& start = backward ? G.inStart : G.outStart;
+    const vector<int>& adj   = backward ? G.inAdj   : G.outAdj;
+    dist.assign(G.n, INT_MAX);
+    vector<int> q(G.n);
+    size_t head = 0, tail = 0;
+    dist[src] = 0; q[tail++] = src;
+    int ecc = 0;
+    while(head < tail){
+        int u = q[head++];
+        for(int i = start[u]; i < start[u+1]; ++i){
+            int v = adj[i];
+            if(dist[v] == INT_MAX){
+                dist[v] = dist[u] + 1;
+                ecc = dist[v];
+                q[tail++] = v;
+            }
+        }
+    }
+    return ecc;
+}
+
+// Flat level layout as in iFUB(): level d is levels[start[d] .. start[d+1]).
+void build_levels(const vector<int>& dist, int D, vector<int>& start, vector<int>& levels){
+    start.assign(D + 2, 0);
+    for(int x : dist) if(x != INT_MAX) start[x + 1]++;
+    for(int d = 0; d <= D; ++d) start[d + 1] += start[d];
+    levels.resize(start[D + 1]);
+    vector<int> pos(start.begin(), start.end() - 1);
+    for(int v = 0; v < (int)dist.size(); ++v)
+        if(dist[v] != INT_MAX) levels[pos[dist[v]]++] = v;
+}
+
+// ——— DiFUB ———
+// A pair (x,y) with d(x,y) > 2(i-1) has d(x,u) >= i or d(u,y) >= i, so once
+// the forward eccentricity of every vertex in backward level i and the
+// backward eccentricity of every vertex in forward level i are known, the
+// remaining pairs are within 2(i-1). Needs G strongly connected.
+int DiFUB(const DiGraph& G, int root, int& bfsCount){
+    vector<int> fdist, bdist, scratch;
+    int eccF = directed_bfs(G, root, false, fdist);
+    int eccB = directed_bfs(G, root, true, bdist);
+    bfsCount = 2;
+    vector<int> fStart, fLevels, bStart, bLevels;
+    build_levels(fdist, eccF, fStart, fLevels);
+    build_levels(bdist, eccB, bStart, bLevels);
+
+    int i = max(eccF, eccB);
+    int lb = i, ub = 2 * i;
+    while(lb < ub && i > 0){
+        if(i <= eccF){
+            for(int k = fStart[i]; k < fStart[i+1]; ++k){
+                lb = max(lb, directed_bfs(G, fLevels[k], true, scratch));
+                bfsCount++;
+            }
+        }
+        if(i <= eccB){
+            for(int k = bStart[i]; k < bStart[i+1]; ++k){
+                lb = max(lb, directed_bfs(G, bLevels[k], false, scratch));
+                bfsCount++;
+            }
+        }
+        ub = max(lb, 2 * (i - 1));
+        --i;
+    }
+    return lb;
+}
+
+// ——— Root selection ———
+int random_root(int n, mt19937& rng) {
+    return rng() % n;
+}
+
+int highest_degree(const DiGraph& G) {
+    int best = 0;
+    for(int v = 1; v < G.n; ++v)
+        if(G.outDeg(v) + G.inDeg(v) > G.outDeg(best) + G.inDeg(best)) best = v;
+    return best;
+}
+
+// Vertex maximising in-degree * out-degree, the root used in the DiFUB paper.
+int highest_in_out(const DiGraph& G) {
+    int best = 0;
+    for(int v = 1; v < G.n; ++v)
+        if((long long)G.outDeg(v) * G.inDeg(v) > (long long)G.outDeg(best) * G.inDeg(best)) best = v;
+    return best;
+}
+
+// ——— main() ———
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        cerr << "Usage: " << argv[0] << " [strategy: 0=random, 1=hd, 2=in*out] graph.mtx [--seed S]\n";
+        return 1;
+    }
+    int strategy = stoi(argv[1]);
+    uint32_t seed = time(0);
+    for(int i = 3; i + 1 < argc; i += 2){
+        string flag = argv[i];
+        if(flag == "--seed") seed = stoul(argv[i+1]);
+        else { cerr << "Unknown option " << flag << "\n"; return 1; }
+    }
+    DiGraph full = load_digraph(argv[2]);
+    mt19937 rng(seed);
+
+    vector<int> comp;
+    int nComp = strongly_connected_components(full, comp);
+    vector<int> size(nComp, 0);
+    for(int c : comp) size[c]++;
+    int largest = max_element(size.begin(), size.end()) - size.begin();
+    DiGraph G = induced_component(full, comp, largest);
+
+    int start_node;
+    if(strategy == 0) start_node = random_root(G.n, rng);
+    else if(strategy == 1) start_node = highest_degree(G);
+    else if(strategy == 2) start_node = highest_in_out(G);
+    else { cerr << "Invalid strategy code\n"; return 1; }
+
+    int bfsCalls = 0;
+    auto t0 = Clock::now();
+    int diam = DiFUB(G, start_node, bfsCalls);
+    auto t1 = Clock::now();
+
+    double seconds = chrono::duration<double>(t1 - t0).count();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long peak_rss = usage.ru_maxrss;
+
+    cout << "Strategy:" << strategy  << "\n"
+         << "Seed:" << seed << "\n"
+         << "Vertices:" << full.n << "\n"
+         << "Arcs:" << full.outAdj.size() << "\n"
+         << "SCCs:" << nComp << "\n"
+         << "Largest_SCC:" << G.n << "\n"
+         << "Diameter:" << diam  << "\n"
+         << "BFS_Calls:" << bfsCalls  << "\n"
+         << "Time(s):" << seconds << "\n"
+         << "Peak_RSS:    " << peak_rss
+                  << (sizeof(peak_rss)==sizeof(long)? " KB":" bytes")
+         << "\n";
+    return 0;
+}
@@ -4,6 +4,8 @@ using namespace std;
 namespace fs = std::filesystem;
 using Clock = chrono::high_resolution_clock;
 
+#include "../common/graph_io.hpp"
+
 using Edge = tuple<int,int,double>;
 
 struct Graph {
@@ -18,35 +20,12 @@ struct Graph {
     }
 };
 
-Graph load_mm_graph(const string& path){
-    ifstream in(path);
-    if(!in) throw runtime_error("Cannot open " + path);
-    string header; getline(in, header);
-    if(header.rfind("%%MatrixMarket", 0) != 0)
-        throw runtime_error("Not a MatrixMarket file");
-    
-    bool is_complex  = header.find("complex") != string::npos;
-
-    bool is_weighted = header.find("real") != string::npos
-                    || header.find("integer") != string::npos;
-
-    string line;
-    while(getline(in,line) && line.size() && line[0] == '%');
-    istringstream iss(line);
-    int M, N, L; iss >> M >> N >> L;
-    if(M != N) throw runtime_error("Only square graphs supported");
-    Graph G(M);
-    for(int i = 0; i < L; i++){
-        int u, v; double w = 1.0;
-        in >> u >> v;
-        if(is_weighted) in >> w;
-        else if(is_complex){
-            double wr, wi;
-            in >> wr >> wi;
-            w = wr;
-        } 
-        G.add_edge(u-1, v-1, w);
-    }
+// Any format of common/graph_io.hpp: .mtx, .gbin (Generator/graph_gen), SNAP
+// edge lists and METIS graphs, optionally .gz/.zst-compressed.
+Graph load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    Graph G(E.n);
+    for(auto& [u,v,w] : E.edges) G.add_edge(u, v, w);
     return G;
 }
 
@@ -68,10 +47,6 @@ int eccentricity(const Graph& G, int src){
     return ecc;
 }
 
-int random_root(int n) {
-    return rand() % n;
-}
-
 int highest_degree(const Graph& G) {
     int max_deg = -1, best = 0;
     for(int i = 0; i < G.n; ++i){
@@ -110,8 +85,6 @@ int four_sweep(const Graph& G, int initial){
 int iFUB(const Graph& G, int root, int& bfsCount){
     vector<int> dist(G.n, INT_MAX);
     queue<int> q; dist[root] = 0; q.push(root);
-    vector<vector<int>> levels(G.n);
-    levels[0].push_back(root);
     int D = 0;
     while(!q.empty()){
         int u = q.front(); q.pop();
@@ -119,66 +92,144 @@ int iFUB(const Graph& G, int root, int& bfsCount){
             if(dist[v] == INT_MAX){
                 dist[v] = dist[u] + 1;
                 D = max(D, dist[v]);
-                if (dist[v] < G.n)
-                    levels[dist[v]].push_back(v);
                 q.push(v);
             }
         }
     }
+    // Flat level layout: counting-sort the reached vertices by root distance,
+    // so level d is levels[levelStart[d] .. levelStart[d+1]).
+    vector<int> levelStart(D + 2, 0), levels;
+    for(int v = 0; v < G.n; ++v)
+        if(dist[v] != INT_MAX) levelStart[dist[v] + 1]++;
+    for(int d = 0; d <= D; ++d) levelStart[d + 1] += levelStart[d];
+    levels.resize(levelStart[D + 1]);
+    {
+        vector<int> pos(levelStart.begin(), levelStart.end() - 1);
+        for(int v = 0; v < G.n; ++v)
+            if(dist[v] != INT_MAX) levels[pos[dist[v]]++] = v;
+    }
 
     int lb = D, ub = 2 * D;
     bfsCount = 1;
 
-    for(int d = D; d >= (ub+1)/2; --d){
-        if (d >= (int)levels.size()) continue;
-        for(int v : levels[d]){
+    for(int d = D; d > 0 && lb < ub; --d){
+        for(int i = levelStart[d]; i < levelStart[d + 1]; ++i){
+            int v = levels[i];
             int ecc = eccentricity(G, v);
             lb = max(lb, ecc);
-            ub = min(ub, 2 * ecc);
             bfsCount++;
             if(lb == ub) return lb;
         }
+        // every vertex above level d-1 is done; pairs below are within 2(d-1)
+        ub = max(lb, 2 * (d - 1));
     }
     return lb;
 
 }
 
+// ——— Pipelined batch runner ———
+// Every file is parsed exactly once by a loader thread that runs ahead of the
+// workers (bounded by `capacity` graphs in memory), so parsing the next file
+// overlaps with iFUB on the current ones. Idle workers take the next loaded
+// graph from the shared queue and run all four strategies on it. With more
+// than one worker the graphs share memory bandwidth, so the per-strategy
+// times are no longer those of an isolated run; the default is one worker.
+struct LoadedGraph {
+    size_t index;
+    unique_ptr<Graph> G;
+};
+
+struct GraphQueue {
+    mutex mu;
+    condition_variable cv;
+    deque<LoadedGraph> items;
+    size_t capacity;
+    bool closed = false;
+    GraphQueue(size_t cap): capacity(cap) {}
+    void push(LoadedGraph g){
+        unique_lock<mutex> lk(mu);
+        cv.wait(lk, [&]{ return items.size() < capacity; });
+        items.push_back(move(g));
+        cv.notify_all();
+    }
+    void close(){
+        lock_guard<mutex> lk(mu);
+        closed = true;
+        cv.notify_all();
+    }
+    bool pop(LoadedGraph& g){
+        unique_lock<mutex> lk(mu);
+        cv.wait(lk, [&]{ return !items.empty() || closed; });
+        if(items.empty()) return false;
+        g = move(items.front());
+        items.pop_front();
+        cv.notify_all();
+        return true;
+    }
+};
+
 int main(int argc, char* argv[]){
-    srand(42);
-    if(argc!=2){
-        cerr<<"Usage: "<<argv[0]<<" folder_path\n";
+    if(argc!=2 && argc!=4){
+        cerr<<"Usage: "<<argv[0]<<" folder_path [--workers W]\n";
         return 1;
     }
     string folder = argv[1];
-    cout<<"strategy,avg_time_s\n";
-
-    for(int strategy=0; strategy<4; ++strategy){
-        double totalTime = 0;
-        int fileCount = 0;
-
-        for(const auto& entry: fs::directory_iterator(folder)){
-            if(entry.path().extension()==".mtx"){
-                try{
-                    Graph G = load_mm_graph(entry.path());
-                    int start;
-                    switch(strategy){
-                      case 0: start = random_root(G.n); break;
-                      case 1: start = highest_degree(G); break;
-                      case 2: start = four_sweep(G, random_root(G.n)); break;
-                      case 3: start = four_sweep(G, highest_degree(G)); break;
-                    }
-                    int bfsCalls;
-                    auto t0 = Clock::now();
-                    iFUB(G, start, bfsCalls);
-                    auto t1 = Clock::now();
-                    totalTime += chrono::duration<double>(t1-t0).count();
-                    ++fileCount;
-                } catch(...){ /* skip bad */ }
+    int workers = 1;
+    if(argc==4 && string(argv[2])=="--workers") workers = max(1, stoi(argv[3]));
+
+    vector<fs::path> files;
+    for(const auto& entry: fs::directory_iterator(folder))
+        if(entry.path().extension()==".mtx" || entry.path().extension()==".gbin")
+            files.push_back(entry.path());
+    sort(files.begin(), files.end());
+
+    GraphQueue ready(workers + 1);
+    thread loader([&]{
+        for(size_t i=0; i<files.size(); ++i){
+            try{
+                ready.push({i, make_unique<Graph>(load_graph(files[i]))});
+            } catch(...){ /* skip bad */ }
+        }
+        ready.close();
+    });
+
+    mutex statsMu;
+    double totalTime[4] = {0,0,0,0};
+    int fileCount = 0;
+    vector<thread> pool;
+    for(int w=0; w<workers; ++w) pool.emplace_back([&]{
+        LoadedGraph item;
+        while(ready.pop(item)){
+            const Graph& G = *item.G;
+            // per-graph RNG so random roots do not depend on scheduling
+            mt19937 rng(42 + item.index);
+            double times[4];
+            for(int strategy=0; strategy<4; ++strategy){
+                int start;
+                switch(strategy){
+                  case 0: start = rng() % G.n; break;
+                  case 1: start = highest_degree(G); break;
+                  case 2: start = four_sweep(G, rng() % G.n); break;
+                  default: start = four_sweep(G, highest_degree(G)); break;
+                }
+                int bfsCalls;
+                auto t0 = Clock::now();
+                iFUB(G, start, bfsCalls);
+                auto t1 = Clock::now();
+                times[strategy] = chrono::duration<double>(t1-t0).count();
             }
+            lock_guard<mutex> lk(statsMu);
+            for(int strategy=0; strategy<4; ++strategy) totalTime[strategy] += times[strategy];
+            ++fileCount;
         }
+    });
+    for(auto& t: pool) t.join();
+    loader.join();
 
-        double avg = fileCount ? totalTime/fileCount : 0;
+    cout<<"strategy,avg_time_s\n";
+    for(int strategy=0; strategy<4; ++strategy){
+        double avg = fileCount ? totalTime[strategy]/fileCount : 0;
         cout<<strategy<<","<<avg<<"\n";
     }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,387 @@
+// PartitionedIFUB.cpp
+// iFUB with every BFS run across P worker processes (--parts P). Vertices are
+// split into P contiguous ranges holding about the same number of arcs (1D
+// partitioning), and each worker process keeps only the adjacency rows of
+// its range. BFS is level-synchronous: a worker expands its share of the
+// frontier and sends neighbours owned by other workers through per-pair
+// queues in a shared-memory segment. Those queues stand in for a network
+// transport; apart from them the workers only share the barriers and the
+// command block. The parent process loads the graph, forks the workers and
+// runs the iFUB loop, issuing one distributed BFS per eccentricity.
+#include <bits/stdc++.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <pthread.h>
+#include <unistd.h>
+using namespace std;
+using Clock = chrono::high_resolution_clock;
+
+#include "../common/graph_io.hpp"
+
+// ——— Graph loading (parent only) ———
+// The shared loaders read every input format Crescenzi.cpp does, and
+// build_graph drops self-loops and repeated edges, so a `general` file does
+// not double the rows or the queue traffic. Weights are ignored (hop
+// distances); the adjacency is then flattened into one CSR for partitioning.
+struct CSR {
+    int n = 0;
+    vector<int64_t> start;
+    vector<int> adj;
+    int64_t deg(int u) const { return start[u+1] - start[u]; }
+};
+
+CSR load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    BasicGraph<void> B = build_graph<void>(E);
+    CSR G;
+    G.n = B.n;
+    G.start.assign(G.n + 1, 0);
+    for(int u = 0; u < G.n; ++u) G.start[u+1] = G.start[u] + B.adj[u].size();
+    G.adj.reserve(G.start[G.n]);
+    for(auto& row : B.adj){
+        for(auto [v,_w] : row) G.adj.push_back(v);
+        row = {};
+    }
+    return G;
+}
+
+// ——— 1D partitioning ———
+// bounds[p] .. bounds[p+1] is partition p; cuts fall where the running arc
+// count passes p * arcs / P, so every worker scans about the same number of arcs.
+vector<int> split_by_arcs(const CSR& G, int P){
+    vector<int> bounds(P + 1, G.n);
+    bounds[0] = 0;
+    int p = 1;
+    for(int u = 0; u < G.n && p < P; ++u)
+        while(p < P && G.start[u] >= (int64_t)G.adj.size() * p / P) bounds[p++] = u;
+    for(int q = 1; q <= P; ++q) bounds[q] = max(bounds[q], bounds[q-1]);
+    return bounds;
+}
+
+int owner_of(const vector<int>& bounds, int v){
+    return upper_bound(bounds.begin(), bounds.end(), v) - bounds.begin() - 1;
+}
+
+// ——— Shared segment ———
+// One anonymous MAP_SHARED mapping created before fork: the command block,
+// the process-shared barriers, the queue lengths, the queues themselves
+// (queue s->d holds at most the ghosts of s owned by d, since a ghost is
+// sent once per BFS), the gathered root distances and the worker statistics.
+enum Op { OP_BFS, OP_GATHER, OP_EXIT };
+
+struct PartStats {
+    int lo, hi;
+    long long arcs, ghosts, bfs;
+    double compute, wait;   // seconds expanding/receiving, seconds in barriers
+    long long sent, received; // vertex ids through the queues
+    long rssKB;
+};
+
+struct Control {
+    pthread_barrier_t all;     // parent + workers: one command
+    pthread_barrier_t workers; // workers: BFS levels
+    int op, src, ecc;
+};
+
+struct Shared {
+    int P = 0, n = 0;
+    Control* ctl;
+    int64_t* nextSize; // [P] next-frontier sizes
+    int64_t* qLen;     // [P*P] filled length of queue s->d
+    int64_t* qOff;     // [P*P] offset of queue s->d in qData
+    int*     qData;
+    int*     dist;     // [n] root distances after OP_GATHER
+    PartStats* stats;  // [P]
+
+    void create(int _P, int _n, const vector<int64_t>& cap){
+        P = _P; n = _n;
+        auto align = [](size_t x){ return (x + 63) & ~size_t(63); };
+        int64_t qTotal = accumulate(cap.begin(), cap.end(), int64_t(0));
+        size_t off[7], sz = 0;
+        size_t bytes[7] = {sizeof(Control), P * 8ul, P * P * 8ul, P * P * 8ul,
+                           size_t(max<int64_t>(qTotal, 1)) * 4, size_t(n) * 4, P * sizeof(PartStats)};
+        for(int i = 0; i < 7; ++i){ off[i] = sz; sz = align(sz + bytes[i]); }
+        char* base = (char*)mmap(nullptr, sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if(base == MAP_FAILED) throw runtime_error("mmap of the shared segment failed");
+        ctl      = (Control*)(base + off[0]);
+        nextSize = (int64_t*)(base + off[1]);
+        qLen     = (int64_t*)(base + off[2]);
+        qOff     = (int64_t*)(base + off[3]);
+        qData    = (int*)(base + off[4]);
+        dist     = (int*)(base + off[5]);
+        stats    = (PartStats*)(base + off[6]);
+        for(int i = 0; i < P * P; ++i) qOff[i] = i ? qOff[i-1] + cap[i-1] : 0;
+
+        pthread_barrierattr_t attr;
+        pthread_barrierattr_init(&attr);
+        pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_barrier_init(&ctl->all, &attr, P + 1);
+        pthread_barrier_init(&ctl->workers, &attr, P);
+        pthread_barrierattr_destroy(&attr);
+    }
+};
+
+// ——— Worker process ———
+// Local adjacency entries are local indices (>= 0) for owned neighbours and
+// -(g+1) for ghost g, a neighbour owned by another worker.
+struct Worker {
+    int me, P, lo, hi;
+    Shared S;
+    vector<int64_t> start;
+    vector<int> adj, ghostId, ghostOwner, ghostSent;
+    vector<int> dist, frontier, next;
+    PartStats st{};
+    int bfsId = 0;
+
+    void build(const CSR& G, const vector<int>& bounds){
+        unordered_map<int,int> ghostOf;
+        start.assign(hi - lo + 1, 0);
+        adj.reserve(G.start[hi] - G.start[lo]);
+        for(int u = lo; u < hi; ++u){
+            for(int64_t i = G.start[u]; i < G.start[u+1]; ++i){
+                int v = G.adj[i];
+                if(v >= lo && v < hi) adj.push_back(v - lo);
+                else {
+                    auto [it, fresh] = ghostOf.try_emplace(v, (int)ghostId.size());
+                    if(fresh){
+                        ghostId.push_back(v);
+                        ghostOwner.push_back(owner_of(bounds, v));
+                    }
+                    adj.push_back(-(it->second + 1));
+                }
+            }
+            start[u - lo + 1] = adj.size();
+        }
+        ghostSent.assign(ghostId.size(), -1);
+        dist.assign(hi - lo, INT_MAX);
+        st.lo = lo; st.hi = hi;
+        st.arcs = adj.size();
+        st.ghosts = ghostId.size();
+    }
+
+    void wait(pthread_barrier_t* b){
+        auto t0 = Clock::now();
+        pthread_barrier_wait(b);
+        st.wait += chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    // Every worker returns the eccentricity of src (-1 never happens: src is reached).
+    int bfs(int src){
+        ++bfsId;
+        ++st.bfs;
+        fill(dist.begin(), dist.end(), INT_MAX);
+        frontier.clear();
+        if(src >= lo && src < hi){
+            dist[src - lo] = 0;
+            frontier.push_back(src - lo);
+        }
+        int level = 0;
+        while(true){
+            auto t0 = Clock::now();
+            for(int d = 0; d < P; ++d) S.qLen[me * P + d] = 0;
+            next.clear();
+            for(int u : frontier)
+                for(int64_t i = start[u]; i < start[u+1]; ++i){
+                    int a = adj[i];
+                    if(a >= 0){
+                        if(dist[a] == INT_MAX){
+                            dist[a] = level + 1;
+                            next.push_back(a);
+                        }
+                    } else {
+                        int g = -a - 1;
+                        if(ghostSent[g] == bfsId) continue;
+                        ghostSent[g] = bfsId;
+                        int o = ghostOwner[g];
+                        S.qData[S.qOff[me * P + o] + S.qLen[me * P + o]++] = ghostId[g];
+                        ++st.sent;
+                    }
+                }
+            st.compute += chrono::duration<double>(Clock::now() - t0).count();
+            wait(&S.ctl->workers);
+
+            t0 = Clock::now();
+            for(int s = 0; s < P; ++s) if(s != me){
+                const int* q = S.qData + S.qOff[s * P + me];
+                int64_t len = S.qLen[s * P + me];
+                st.received += len;
+                for(int64_t i = 0; i < len; ++i){
+                    int a = q[i] - lo;
+                    if(dist[a] == INT_MAX){
+                        dist[a] = level + 1;
+                        next.push_back(a);
+                    }
+                }
+            }
+            S.nextSize[me] = next.size();
+            st.compute += chrono::duration<double>(Clock::now() - t0).count();
+            wait(&S.ctl->workers);
+
+            int64_t total = 0;
+            for(int p = 0; p < P; ++p) total += S.nextSize[p];
+            if(total == 0) return level;
+            ++level;
+            frontier.swap(next);
+        }
+    }
+
+    [[noreturn]] void serve(){
+        while(true){
+            pthread_barrier_wait(&S.ctl->all);
+            int op = S.ctl->op;
+            if(op == OP_BFS){
+                int ecc = bfs(S.ctl->src);
+                if(me == 0) S.ctl->ecc = ecc;
+            } else if(op == OP_GATHER){
+                for(int v = lo; v < hi; ++v) S.dist[v] = dist[v - lo];
+            } else {
+                struct rusage usage;
+                getrusage(RUSAGE_SELF, &usage);
+                st.rssKB = usage.ru_maxrss;
+                S.stats[me] = st;
+                pthread_barrier_wait(&S.ctl->all);
+                _exit(0);
+            }
+            pthread_barrier_wait(&S.ctl->all);
+        }
+    }
+};
+
+// ——— Parent: commands and iFUB ———
+int remote_bfs(Shared& S, int src){
+    S.ctl->op = OP_BFS;
+    S.ctl->src = src;
+    pthread_barrier_wait(&S.ctl->all);
+    pthread_barrier_wait(&S.ctl->all);
+    return S.ctl->ecc;
+}
+
+void remote_command(Shared& S, Op op){
+    S.ctl->op = op;
+    pthread_barrier_wait(&S.ctl->all);
+    pthread_barrier_wait(&S.ctl->all);
+}
+
+// As iFUB() in Crescenzi.cpp, with the root distances gathered from the
+// workers to lay out the fringe levels.
+int partitioned_iFUB(Shared& S, int root, int& bfsCount){
+    int D = remote_bfs(S, root);
+    remote_command(S, OP_GATHER);
+    vector<int> levelStart(D + 2, 0), levels;
+    for(int v = 0; v < S.n; ++v) if(S.dist[v] != INT_MAX) levelStart[S.dist[v] + 1]++;
+    for(int d = 0; d <= D; ++d) levelStart[d + 1] += levelStart[d];
+    levels.resize(levelStart[D + 1]);
+    vector<int> pos(levelStart.begin(), levelStart.end() - 1);
+    for(int v = 0; v < S.n; ++v) if(S.dist[v] != INT_MAX) levels[pos[S.dist[v]]++] = v;
+
+    int lb = D, ub = 2 * D;
+    bfsCount = 1;
+    for(int d = D; d > 0 && lb < ub; --d){
+        for(int i = levelStart[d]; i < levelStart[d + 1]; ++i){
+            lb = max(lb, remote_bfs(S, levels[i]));
+            bfsCount++;
+            if(lb == ub) return lb;
+        }
+        ub = max(lb, 2 * (d - 1));
+    }
+    return lb;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        cerr << "Usage: " << argv[0] << " [strategy: 0=random, 1=hd] graph.mtx [--parts P] [--seed S]\n";
+        return 1;
+    }
+    int strategy = stoi(argv[1]);
+    int P = 2;
+    uint32_t seed = time(0);
+    for(int i = 3; i + 1 < argc; i += 2){
+        string flag = argv[i];
+        if(flag == "--parts") P = max(1, stoi(argv[i+1]));
+        else if(flag == "--seed") seed = stoul(argv[i+1]);
+        else { cerr << "Unknown option " << flag << "\n"; return 1; }
+    }
+    if(strategy != 0 && strategy != 1){ cerr << "Invalid strategy code\n"; return 1; }
+
+    CSR G = load_graph(argv[2]);
+    if(G.n == 0){ cerr << "Empty graph\n"; return 1; }
+    BUILD.report(cerr);
+    P = min(P, G.n);
+    vector<int> bounds = split_by_arcs(G, P);
+
+    int root = 0;
+    if(strategy == 0){
+        mt19937 rng(seed);
+        root = rng() % G.n;
+    } else {
+        for(int v = 1; v < G.n; ++v) if(G.deg(v) > G.deg(root)) root = v;
+    }
+
+    // queue s->d capacity: distinct neighbours of partition s owned by d
+    vector<int64_t> cap(P * P, 0);
+    {
+        vector<int> seenBy(G.n, -1);
+        for(int s = 0; s < P; ++s)
+            for(int u = bounds[s]; u < bounds[s+1]; ++u)
+                for(int64_t i = G.start[u]; i < G.start[u+1]; ++i){
+                    int v = G.adj[i];
+                    if((v < bounds[s] || v >= bounds[s+1]) && seenBy[v] != s){
+                        seenBy[v] = s;
+                        cap[s * P + owner_of(bounds, v)]++;
+                    }
+                }
+    }
+    Shared S;
+    S.create(P, G.n, cap);
+
+    vector<pid_t> pids;
+    for(int p = 0; p < P; ++p){
+        pid_t pid = fork();
+        if(pid < 0) throw runtime_error("fork failed");
+        if(pid == 0){
+            Worker W;
+            W.me = p; W.P = P; W.S = S;
+            W.lo = bounds[p]; W.hi = bounds[p+1];
+            W.build(G, bounds);
+            G = CSR(); // drop this process's view of the whole graph
+            W.serve();
+        }
+        pids.push_back(pid);
+    }
+    int n = G.n;
+    int64_t arcs = G.adj.size();
+    G = CSR();
+
+    int bfsCalls = 0;
+    auto t0 = Clock::now();
+    int diam = partitioned_iFUB(S, root, bfsCalls);
+    double seconds = chrono::duration<double>(Clock::now() - t0).count();
+    remote_command(S, OP_EXIT);
+    for(pid_t pid : pids) waitpid(pid, nullptr, 0);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long long sent = 0;
+    for(int p = 0; p < P; ++p) sent += S.stats[p].sent;
+
+    cout << "Strategy:" << strategy << "\n"
+         << "Seed:" << seed << "\n"
+         << "Partitions:" << P << "\n"
+         << "Vertices:" << n << "\n"
+         << "Arcs:" << arcs << "\n"
+         << "Root:" << root << "\n"
+         << "Diameter:" << diam << "\n"
+         << "BFS_Calls:" << bfsCalls << "\n"
+         << "Time(s):" << seconds << "\n"
+         << "Comm_Bytes:" << sent * (long long)sizeof(int) << "\n"
+         << "Peak_RSS:    " << usage.ru_maxrss << " KB\n"
+         << "# part,first_vertex,vertices,arcs,ghosts,bfs,compute_s,wait_s,sent,received,peak_rss_kb\n";
+    for(int p = 0; p < P; ++p){
+        auto& s = S.stats[p];
+        cout << p << "," << s.lo << "," << s.hi - s.lo << "," << s.arcs << "," << s.ghosts << ","
+             << s.bfs << "," << s.compute << "," << s.wait << "," << s.sent << ","
+             << s.received << "," << s.rssKB << "\n";
+    }
+    return 0;
+}
@@ -2,6 +2,8 @@
 #include <sys/resource.h>
 using namespace std;
 using Clock = chrono::high_resolution_clock;
+
+#include "../common/graph_io.hpp"
 using Edge  = tuple<int,int,double>;
 
 struct Graph {
@@ -14,20 +16,12 @@ struct Graph {
     }
 };
 
-Graph load_mm(const string& p){
-    ifstream in(p);
-    string h; getline(in,h);
-    bool w = h.find("real")!=string::npos||h.find("integer")!=string::npos;
-    string line;
-    while(getline(in,line) && line[0]=='%');
-    int M,N,L; istringstream(line)>>M>>N>>L;
-    Graph G(M);
-    for(int i=0;i<L;i++){
-        int u,v; double ww=1;
-        in>>u>>v;
-        if(w) in>>ww;
-        G.add_edge(u-1,v-1,ww);
-    }
+// Any format of common/graph_io.hpp: .mtx, .gbin (Generator/graph_gen), SNAP
+// edge lists and METIS graphs, optionally .gz/.zst-compressed.
+Graph load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    Graph G(E.n);
+    for(auto& [u,v,w] : E.edges) G.add_edge(u, v, w);
     return G;
 }
 
@@ -76,27 +70,34 @@ int four_sweep(const Graph& G,int r){
 int iFUB(const Graph& G,int root,int& bfsCount){
     vector<int>d(G.n,INT_MAX);
     queue<int>q; d[root]=0; q.push(root);
-    vector<vector<int>>lvl(G.n);
-    lvl[0].push_back(root);
     int D=0;
     while(!q.empty()){
         int u=q.front();q.pop();
         for(auto& [_,v,_w]:G.adj[u]) if(d[v]==INT_MAX){
             d[v]=d[u]+1;
             D = max(D,d[v]);
-            lvl[d[v]].push_back(v);
             q.push(v);
         }
     }
+    // flat levels: counting sort by root distance, level dd is lvl[ls[dd]..ls[dd+1])
+    vector<int> ls(D+2,0), lvl;
+    for(int v=0;v<G.n;v++) if(d[v]!=INT_MAX) ls[d[v]+1]++;
+    for(int dd=0;dd<=D;dd++) ls[dd+1]+=ls[dd];
+    lvl.resize(ls[D+1]);
+    {
+        vector<int> pos(ls.begin(),ls.end()-1);
+        for(int v=0;v<G.n;v++) if(d[v]!=INT_MAX) lvl[pos[d[v]]++]=v;
+    }
     int lb=D, ub=2*D; bfsCount=1;
-    for(int dd=D; dd>= (ub+1)/2; --dd){
-        for(int v:lvl[dd]){
+    for(int dd=D; dd>0 && lb<ub; --dd){
+        for(int i=ls[dd];i<ls[dd+1];i++){
+            int v=lvl[i];
             int e=eccentricity(G,v);
             lb=max(lb,e);
-            ub=min(ub,2*e);
             bfsCount++;
             if(lb==ub) return lb;
         }
+        ub=max(lb,2*(dd-1)); // pairs below level dd are within 2(dd-1)
     }
     return lb;
 }
@@ -110,7 +111,7 @@ int main(int argc,char**argv){
     if(argc!=2){
         cerr<<"Usage: "<<argv[0]<<" graph.mtx\n"; return 1;
     }
-    Graph G = load_mm(argv[1]);
+    Graph G = load_graph(argv[1]);
     srand(0);
     cout<<"strategy,bfs_calls\n";
     for(int s=0;s<4;s++){
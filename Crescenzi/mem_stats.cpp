@@ -1,12 +1,51 @@
 #include <bits/stdc++.h>
-#include <sys/resource.h>
 using namespace std;
 using Clock = chrono::high_resolution_clock;
+
+#include "../common/graph_io.hpp"
 using Edge  = tuple<int,int,double>;
 
+// ——— Allocation tracking ———
+// ru_maxrss is a process-wide high-water mark, so strategies run later in the
+// same process inherit the peaks of earlier ones. Every container below uses
+// a counting allocator tagged with the structure it belongs to instead; peaks
+// are reset at the start of each phase so each strategy is measured on its own.
+enum MemCat { MEM_GRAPH, MEM_DIST, MEM_LEVELS, MEM_QUEUE, MEM_CATS };
+const char* MEM_NAMES[MEM_CATS] = {"graph","dist","levels","queue"};
+struct MemCounter { size_t live=0, peak=0; };
+MemCounter MEM[MEM_CATS], MEM_TOTAL;
+
+void mem_add(int c,ptrdiff_t b){
+    MEM[c].live+=b; MEM[c].peak=max(MEM[c].peak,MEM[c].live);
+    MEM_TOTAL.live+=b; MEM_TOTAL.peak=max(MEM_TOTAL.peak,MEM_TOTAL.live);
+}
+void mem_reset_peaks(){
+    for(auto& m:MEM) m.peak=m.live;
+    MEM_TOTAL.peak=MEM_TOTAL.live;
+}
+
+template<class T,int Cat> struct TrackedAlloc {
+    using value_type=T;
+    template<class U> struct rebind { using other=TrackedAlloc<U,Cat>; };
+    TrackedAlloc()=default;
+    template<class U> TrackedAlloc(const TrackedAlloc<U,Cat>&){}
+    T* allocate(size_t n){
+        mem_add(Cat,n*sizeof(T));
+        return static_cast<T*>(::operator new(n*sizeof(T)));
+    }
+    void deallocate(T* p,size_t n){
+        mem_add(Cat,-(ptrdiff_t)(n*sizeof(T)));
+        ::operator delete(p);
+    }
+    template<class U> bool operator==(const TrackedAlloc<U,Cat>&) const { return true; }
+    template<class U> bool operator!=(const TrackedAlloc<U,Cat>&) const { return false; }
+};
+template<class T,int Cat> using tvector = vector<T,TrackedAlloc<T,Cat>>;
+using tqueue = queue<int,deque<int,TrackedAlloc<int,MEM_QUEUE>>>;
+
 struct Graph {
     int n;
-    vector<vector<Edge>> adj;
+    tvector<tvector<Edge,MEM_GRAPH>,MEM_GRAPH> adj;
     Graph(int _n): n(_n), adj(n){}
     void add_edge(int u,int v,double w=1){
         adj[u].emplace_back(u,v,w);
@@ -14,26 +53,18 @@ struct Graph {
     }
 };
 
-Graph load_mm(const string& p){
-    ifstream in(p);
-    string h; getline(in,h);
-    bool w = h.find("real")!=string::npos||h.find("integer")!=string::npos;
-    string line;
-    while(getline(in,line) && line[0]=='%');
-    int M,N,L; istringstream(line)>>M>>N>>L;
-    Graph G(M);
-    for(int i=0;i<L;i++){
-        int u,v; double ww=1;
-        in>>u>>v;
-        if(w) in>>ww;
-        G.add_edge(u-1,v-1,ww);
-    }
+// Any format of common/graph_io.hpp: .mtx, .gbin (Generator/graph_gen), SNAP
+// edge lists and METIS graphs, optionally .gz/.zst-compressed.
+Graph load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    Graph G(E.n);
+    for(auto& [u,v,w] : E.edges) G.add_edge(u, v, w);
     return G;
 }
 
 int eccentricity(const Graph& G,int s){
-    vector<int>d(G.n,INT_MAX);
-    queue<int>q; d[s]=0; q.push(s);
+    tvector<int,MEM_DIST>d(G.n,INT_MAX);
+    tqueue q; d[s]=0; q.push(s);
     int ecc=0;
     while(!q.empty()){
         int u=q.front();q.pop();
@@ -56,8 +87,8 @@ int highest_degree(const Graph& G){
 }
 int four_sweep(const Graph& G,int r){
     auto far=[&](int src){
-        vector<int>d(G.n,INT_MAX);
-        queue<int>q; d[src]=0; q.push(src);
+        tvector<int,MEM_DIST>d(G.n,INT_MAX);
+        tqueue q; d[src]=0; q.push(src);
         int f=src;
         while(!q.empty()){
             int u=q.front();q.pop();
@@ -74,56 +105,68 @@ int four_sweep(const Graph& G,int r){
 }
 
 int iFUB(const Graph& G,int root,int& bfsCount){
-    vector<int>d(G.n,INT_MAX);
-    queue<int>q; d[root]=0; q.push(root);
-    vector<vector<int>>lvl(G.n);
-    lvl[0].push_back(root);
+    tvector<int,MEM_DIST>d(G.n,INT_MAX);
+    tqueue q; d[root]=0; q.push(root);
     int D=0;
     while(!q.empty()){
         int u=q.front();q.pop();
         for(auto& [_,v,_w]:G.adj[u]) if(d[v]==INT_MAX){
             d[v]=d[u]+1;
             D = max(D,d[v]);
-            lvl[d[v]].push_back(v);
             q.push(v);
         }
     }
+    // flat levels: counting sort by root distance, level dd is lvl[ls[dd]..ls[dd+1])
+    tvector<int,MEM_LEVELS> ls(D+2,0), lvl;
+    for(int v=0;v<G.n;v++) if(d[v]!=INT_MAX) ls[d[v]+1]++;
+    for(int dd=0;dd<=D;dd++) ls[dd+1]+=ls[dd];
+    lvl.resize(ls[D+1]);
+    {
+        tvector<int,MEM_LEVELS> pos(ls.begin(),ls.end()-1);
+        for(int v=0;v<G.n;v++) if(d[v]!=INT_MAX) lvl[pos[d[v]]++]=v;
+    }
     int lb=D, ub=2*D; bfsCount=1;
-    for(int dd=D; dd>= (ub+1)/2; --dd){
-        for(int v:lvl[dd]){
+    for(int dd=D; dd>0 && lb<ub; --dd){
+        for(int i=ls[dd];i<ls[dd+1];i++){
+            int v=lvl[i];
             int e=eccentricity(G,v);
             lb=max(lb,e);
-            ub=min(ub,2*e);
             bfsCount++;
             if(lb==ub) return lb;
         }
+        ub=max(lb,2*(dd-1)); // pairs below level dd are within 2(dd-1)
     }
     return lb;
 }
 
-long peak_kb(){
-    struct rusage u; getrusage(RUSAGE_SELF,&u);
-    return u.ru_maxrss; 
+void print_phase(int s,const char* phase){
+    for(int c=0;c<MEM_CATS;c++)
+        cout<<s<<","<<phase<<","<<MEM_NAMES[c]<<","<<MEM[c].live<<","<<MEM[c].peak<<"\n";
+    cout<<s<<","<<phase<<",total,"<<MEM_TOTAL.live<<","<<MEM_TOTAL.peak<<"\n";
 }
 
 int main(int argc,char**argv){
     if(argc!=2){
         cerr<<"Usage: "<<argv[0]<<" graph.mtx\n"; return 1;
     }
-    Graph G = load_mm(argv[1]);
+    Graph G = load_graph(argv[1]);
     srand(0);
-    cout<<"strategy,peak_rss_kb\n";
+    cout<<"strategy,phase,structure,live_bytes,peak_bytes\n";
+    print_phase(-1,"load");
     for(int s=0;s<4;s++){
         int root;
+        mem_reset_peaks();
         switch(s){
             case 0: root=random_root(G.n); break;
             case 1: root=highest_degree(G); break;
             case 2: root=four_sweep(G,random_root(G.n)); break;
             default:root=four_sweep(G,highest_degree(G));break;
         }
+        print_phase(s,"root_selection");
+        mem_reset_peaks();
         int bfsC;
         iFUB(G,root,bfsC);
-        cout<<s<<","<<peak_kb()<<"\n";
+        print_phase(s,"ifub");
     }
     return 0;
 }
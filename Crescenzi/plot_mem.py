@@ -12,13 +12,21 @@ def main(csv_path):
         2: "4s-rand",
         3: "4s-hd"
     }
+    df = df[(df['strategy'] >= 0) & (df['structure'] == 'total')]
     df['strategy_name'] = df['strategy'].map(names)
 
-    plt.figure(figsize=(6,4))
-    plt.bar(df['strategy_name'], df['peak_rss_kb'] / 1024, color='C0')
-    plt.ylabel("Peak RSS (MB)")
+    # the total row's peak is the simultaneous high-water mark of a phase;
+    # per-structure peaks can fall at different times and must not be stacked
+    peaks = (df.pivot_table(index='strategy_name', columns='phase',
+                            values='peak_bytes', aggfunc='max', sort=False)
+               / (1024 * 1024))
+
+    peaks.plot(kind='bar', figsize=(7,4))
+    plt.ylabel("Peak tracked memory (MB)")
     plt.xlabel("Strategy")
+    plt.xticks(rotation=0)
     plt.title("iFUB Peak Memory by Root‐Selection Strategy")
+    plt.legend(title="Phase")
     plt.tight_layout()
     plt.show()
 
@@ -0,0 +1,268 @@
+// graph_gen.cpp
+// Synthetic graph generator for scaling experiments. Writes either the binary
+// GBIN edge list understood by every diameter binary (load_graph()) or a
+// MatrixMarket pattern file.
+//
+// GBIN layout (little endian):
+//   char[4] "GBIN" | uint32 version=1 | uint64 n | uint64 m | m x (uint32 u, uint32 v)
+// Vertices are 0-based; each undirected edge is stored once.
+//
+// All generators are counter-based: the random stream of work item i depends
+// only on (seed, i), so output is identical for any thread count. Work is
+// produced in chunks, generated in parallel and streamed to disk in order, so
+// memory stays bounded by threads x chunk size regardless of m. gen_geo also
+// holds O(n) point coordinates and a cell grid.
+#include <bits/stdc++.h>
+using namespace std;
+using Clock = chrono::high_resolution_clock;
+using EdgeList = vector<pair<uint32_t,uint32_t>>;
+
+// ——— Counter-based random numbers ———
+static inline uint64_t mix64(uint64_t x){
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+struct Rng {
+    uint64_t s;
+    Rng(uint64_t seed, uint64_t stream): s(mix64(seed ^ mix64(stream))) {}
+    uint64_t next(){ return s = mix64(s); }
+    double uniform(){ return (next() >> 11) * 0x1.0p-53; }
+    uint64_t below(uint64_t n){ return next() % n; }
+};
+
+// ——— Output sinks ———
+struct EdgeWriter {
+    FILE* f = nullptr;
+    bool mtx = false;
+    uint64_t n = 0, m = 0;
+    EdgeWriter(const string& path, uint64_t _n): n(_n) {
+        mtx = path.size() >= 4 && path.substr(path.size()-4) == ".mtx";
+        f = fopen(path.c_str(), "wb");
+        if(!f) throw runtime_error("Cannot open "+path);
+        setvbuf(f, nullptr, _IOFBF, 1 << 22);
+        write_header();
+    }
+    // The edge count is only known at the end, so the header is rewritten then.
+    // MatrixMarket gets a fixed-width size line for the same reason.
+    void write_header(){
+        if(mtx){
+            fprintf(f, "%%%%MatrixMarket matrix coordinate pattern symmetric\n");
+            fprintf(f, "%20llu %20llu %20llu\n", (unsigned long long)n,
+                    (unsigned long long)n, (unsigned long long)m);
+        } else {
+            uint32_t version = 1;
+            fwrite("GBIN", 1, 4, f);
+            fwrite(&version, 4, 1, f);
+            fwrite(&n, 8, 1, f);
+            fwrite(&m, 8, 1, f);
+        }
+    }
+    void write(const EdgeList& E){
+        if(mtx){
+            // MatrixMarket symmetric stores the lower triangle, 1-based.
+            for(auto [u,v] : E)
+                fprintf(f, "%u %u\n", max(u,v) + 1, min(u,v) + 1);
+        } else {
+            fwrite(E.data(), sizeof(E[0]), E.size(), f);
+        }
+        m += E.size();
+    }
+    void close(){
+        fflush(f);
+        rewind(f);
+        write_header();
+        fclose(f);
+    }
+};
+
+// ——— Parallel chunk driver ———
+// Splits [0, items) into chunks, generates `threads` chunks at a time and
+// writes them in order. gen(lo, hi, out) must only depend on its range.
+template<class Gen>
+void generate_chunks(uint64_t items, uint64_t chunk, int threads,
+                     EdgeWriter& W, Gen gen){
+    uint64_t nChunks = (items + chunk - 1) / chunk;
+    vector<EdgeList> bufs(threads);
+    for(uint64_t base = 0; base < nChunks; base += threads){
+        vector<thread> pool;
+        for(int t = 0; t < threads; ++t){
+            uint64_t c = base + t;
+            bufs[t].clear();
+            if(c >= nChunks) continue;
+            pool.emplace_back([&, c, t]{
+                gen(c * chunk, min(items, (c + 1) * chunk), bufs[t]);
+            });
+        }
+        for(auto& th : pool) th.join();
+        for(int t = 0; t < threads && base + t < nChunks; ++t) W.write(bufs[t]);
+    }
+}
+
+// ——— Generators ———
+
+// R-MAT / Kronecker: n = 2^scale, m = edgeFactor * n, quadrant probabilities a,b,c,d.
+void gen_rmat(EdgeWriter& W, int scale, uint64_t m, double a, double b, double c,
+              uint64_t seed, int threads){
+    generate_chunks(m, 1 << 16, threads, W, [&](uint64_t lo, uint64_t hi, EdgeList& out){
+        for(uint64_t e = lo; e < hi; ++e){
+            Rng r(seed, e);
+            uint32_t u = 0, v = 0;
+            for(int bit = 0; bit < scale; ++bit){
+                double p = r.uniform();
+                int q = p < a ? 0 : p < a + b ? 1 : p < a + b + c ? 2 : 3;
+                u = (u << 1) | (q >> 1);
+                v = (v << 1) | (q & 1);
+            }
+            if(u != v) out.emplace_back(u, v);
+        }
+    });
+}
+
+// Barabási-Albert with k edges per new vertex, in the parallel formulation of
+// Sanders & Schulz: position 2i of the edge array holds the new vertex of edge
+// i, position 2i+1 copies a uniformly random earlier position. Resolving a
+// position follows those copies, so every edge is computed independently.
+void gen_ba(EdgeWriter& W, uint64_t n, uint64_t k, uint64_t seed, int threads){
+    auto resolve = [&](uint64_t pos){
+        while(pos & 1) pos = Rng(seed, pos).below(pos);
+        return uint32_t(pos / (2 * k));
+    };
+    uint64_t m = (n - 1) * k; // vertex 0 has no out-edges
+    generate_chunks(m, 1 << 16, threads, W, [&](uint64_t lo, uint64_t hi, EdgeList& out){
+        for(uint64_t e = lo; e < hi; ++e){
+            uint64_t i = e + k; // skip vertex 0's slots
+            uint32_t u = uint32_t(i / k), v = resolve(2 * i + 1);
+            if(u != v) out.emplace_back(u, v);
+        }
+    });
+}
+
+// Watts-Strogatz: ring lattice with k/2 neighbours per side, each edge's far
+// end rewired to a uniform vertex with probability beta.
+void gen_ws(EdgeWriter& W, uint64_t n, uint64_t k, double beta, uint64_t seed, int threads){
+    uint64_t half = max<uint64_t>(1, k / 2);
+    generate_chunks(n, 1 << 14, threads, W, [&](uint64_t lo, uint64_t hi, EdgeList& out){
+        for(uint64_t u = lo; u < hi; ++u){
+            for(uint64_t j = 1; j <= half; ++j){
+                Rng r(seed, u * half + j);
+                uint64_t v = (u + j) % n;
+                if(r.uniform() < beta) v = r.below(n);
+                if(v != u) out.emplace_back(uint32_t(u), uint32_t(v));
+            }
+        }
+    });
+}
+
+// 2D (nz = 1) or 3D grid with 4/6-neighbourhood.
+void gen_grid(EdgeWriter& W, uint64_t nx, uint64_t ny, uint64_t nz, int threads){
+    generate_chunks(nx * ny * nz, 1 << 16, threads, W, [&](uint64_t lo, uint64_t hi, EdgeList& out){
+        for(uint64_t id = lo; id < hi; ++id){
+            uint64_t x = id % nx, y = (id / nx) % ny, z = id / (nx * ny);
+            if(x + 1 < nx) out.emplace_back(uint32_t(id), uint32_t(id + 1));
+            if(y + 1 < ny) out.emplace_back(uint32_t(id), uint32_t(id + nx));
+            if(z + 1 < nz) out.emplace_back(uint32_t(id), uint32_t(id + nx * ny));
+        }
+    });
+}
+
+// Random geometric graph in the unit square with radius chosen for the
+// requested average degree; at deg ~6 this is a cheap stand-in for the
+// Delaunay meshes in Dataset/. Points are bucketed into r x r cells and each
+// cell is compared with itself and four "forward" neighbours. Unlike the other
+// generators this holds O(n) state: ~20 bytes per vertex at deg 6.
+void gen_geo(EdgeWriter& W, uint64_t n, double deg, uint64_t seed, int threads){
+    double r = sqrt(deg / (M_PI * n));
+    uint64_t g = max<uint64_t>(1, uint64_t(1.0 / r));
+    vector<float> px(n), py(n);
+    vector<uint64_t> cellStart(g * g + 1, 0);
+    auto cellOf = [&](uint64_t i){
+        uint64_t cx = min<uint64_t>(g - 1, uint64_t(px[i] * g));
+        uint64_t cy = min<uint64_t>(g - 1, uint64_t(py[i] * g));
+        return cy * g + cx;
+    };
+    for(uint64_t i = 0; i < n; ++i){
+        Rng rr(seed, i);
+        px[i] = float(rr.uniform());
+        py[i] = float(rr.uniform());
+        cellStart[cellOf(i) + 1]++;
+    }
+    for(uint64_t c = 0; c < g * g; ++c) cellStart[c + 1] += cellStart[c];
+    vector<uint32_t> order(n);
+    {
+        vector<uint64_t> pos(cellStart.begin(), cellStart.end() - 1);
+        for(uint64_t i = 0; i < n; ++i) order[pos[cellOf(i)]++] = uint32_t(i);
+    }
+    float r2 = float(r * r);
+    const int dx[] = {0, 1, -1, 0, 1}, dy[] = {0, 0, 1, 1, 1};
+    generate_chunks(g * g, 1 << 10, threads, W, [&](uint64_t lo, uint64_t hi, EdgeList& out){
+        for(uint64_t c = lo; c < hi; ++c){
+            int64_t cx = c % g, cy = c / g;
+            for(int k = 0; k < 5; ++k){
+                int64_t ox = cx + dx[k], oy = cy + dy[k];
+                if(ox < 0 || oy < 0 || ox >= (int64_t)g || oy >= (int64_t)g) continue;
+                uint64_t o = oy * g + ox;
+                for(uint64_t a = cellStart[c]; a < cellStart[c+1]; ++a){
+                    uint64_t bBegin = (k == 0) ? a + 1 : cellStart[o];
+                    for(uint64_t b = bBegin; b < cellStart[o+1]; ++b){
+                        uint32_t u = order[a], v = order[b];
+                        float ddx = px[u] - px[v], ddy = py[u] - py[v];
+                        if(ddx * ddx + ddy * ddy <= r2) out.emplace_back(u, v);
+                    }
+                }
+            }
+        }
+    });
+}
+
+// ——— main() ———
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        cerr << "Usage: " << argv[0] << " <rmat|ba|ws|grid2d|grid3d|geo> out.{gbin|mtx} [options]\n"
+             << "  --seed S            random seed (default 1)\n"
+             << "  --threads T         worker threads (default: all cores)\n"
+             << "  rmat:   --scale S --edge-factor E [--a A --b B --c C]\n"
+             << "  ba:     --n N --k K\n"
+             << "  ws:     --n N --k K --beta P\n"
+             << "  grid2d: --nx X --ny Y        grid3d: --nx X --ny Y --nz Z\n"
+             << "  geo:    --n N --deg D\n";
+        return 1;
+    }
+    string kind = argv[1], out = argv[2];
+    map<string,string> opt;
+    for(int i = 3; i + 1 < argc; i += 2) opt[argv[i]] = argv[i+1];
+    auto get = [&](const string& k, double def){
+        return opt.count(k) ? stod(opt[k]) : def;
+    };
+    uint64_t seed = uint64_t(get("--seed", 1));
+    int threads = int(get("--threads", max(1u, thread::hardware_concurrency())));
+
+    uint64_t n;
+    if(kind == "rmat")        n = 1ULL << int(get("--scale", 16));
+    else if(kind == "grid2d") n = uint64_t(get("--nx", 256)) * uint64_t(get("--ny", 256));
+    else if(kind == "grid3d") n = uint64_t(get("--nx", 64)) * uint64_t(get("--ny", 64)) * uint64_t(get("--nz", 64));
+    else                      n = uint64_t(get("--n", 1 << 16));
+    if(n == 0 || n > UINT32_MAX){ cerr << "Vertex count must be in [1, 2^32)\n"; return 1; }
+
+    auto t0 = Clock::now();
+    EdgeWriter W(out, n);
+    if(kind == "rmat"){
+        int scale = int(get("--scale", 16));
+        gen_rmat(W, scale, uint64_t(get("--edge-factor", 16) * n),
+                 get("--a", 0.57), get("--b", 0.19), get("--c", 0.19), seed, threads);
+    }
+    else if(kind == "ba")     gen_ba(W, n, uint64_t(get("--k", 4)), seed, threads);
+    else if(kind == "ws")     gen_ws(W, n, uint64_t(get("--k", 6)), get("--beta", 0.1), seed, threads);
+    else if(kind == "grid2d") gen_grid(W, uint64_t(get("--nx", 256)), uint64_t(get("--ny", 256)), 1, threads);
+    else if(kind == "grid3d") gen_grid(W, uint64_t(get("--nx", 64)), uint64_t(get("--ny", 64)),
+                                       uint64_t(get("--nz", 64)), threads);
+    else if(kind == "geo")    gen_geo(W, n, get("--deg", 6), seed, threads);
+    else { cerr << "Unknown generator " << kind << "\n"; return 1; }
+    W.close();
+    double seconds = chrono::duration<double>(Clock::now() - t0).count();
+
+    cerr << "Generated " << kind << ": n=" << n << " m=" << W.m
+         << " in " << seconds << " s (" << threads << " threads)\n";
+    return 0;
+}
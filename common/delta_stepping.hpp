@@ -0,0 +1,133 @@
+// delta_stepping.hpp
+// Parallel delta-stepping SSSP (--sssp delta) shared by takes_kosters,
+// bfs_diameter and implement2. Arcs bind as `auto [v, w]`.
+#pragma once
+#include <bits/stdc++.h>
+#include "parallel_bfs.hpp" // SpinBarrier
+using namespace std;
+
+// ——— Parallel delta-stepping SSSP ———
+// Alternative to the binary-heap Dijkstra for weighted graphs (--sssp delta).
+// Tentative distances live in buckets of width delta. The current bucket is
+// settled in phases that relax only light edges (w <= delta), which may
+// re-insert vertices into the same bucket; heavy edges of everything settled
+// in the bucket are relaxed once afterwards. Each thread keeps its own bucket
+// lists, and distances are lowered with a CAS loop, so no locks are needed.
+struct DeltaConfig {
+    bool   enabled = false;
+    double delta   = 0;   // 0: choose from the graph; --delta must be > 0
+    int    threads = max(1u, thread::hardware_concurrency());
+};
+inline DeltaConfig DELTA;
+
+// Meyer & Sanders: delta ~ max weight / average degree balances the number
+// of buckets against re-relaxations; never below the lightest edge. Bucket
+// indices divide by delta, so all-zero weights fall back to 1.
+template<class Graph>
+double auto_delta(const Graph& G){
+    double maxW = 0, minW = numeric_limits<double>::infinity();
+    size_t m = 0;
+    for(auto& nbrs : G.adj)
+        for(auto [v,w] : nbrs){ maxW = max(maxW, w); minW = min(minW, w); ++m; }
+    if(m == 0) return 1.0;
+    double avgDeg = double(m) / max(1, G.n);
+    double delta = max(minW, maxW / max(1.0, avgDeg));
+    return delta > 0 ? delta : 1.0;
+}
+
+inline bool atomic_min_double(double* addr, double val){
+    double cur;
+    __atomic_load(addr, &cur, __ATOMIC_RELAXED);
+    while(val < cur){
+        if(__atomic_compare_exchange(addr, &cur, &val, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return true;
+    }
+    return false;
+}
+
+template<class Graph, class Dist>
+void delta_stepping(const Graph& G, int src, Dist& d){
+    const int T = DELTA.threads;
+    const double delta = DELTA.delta;
+    const double INF = numeric_limits<double>::infinity();
+    d.assign(G.n, INF);
+    d[src] = 0;
+    vector<vector<vector<int>>> buckets(T); // buckets[thread][bucket]
+    vector<vector<int>> settled(T);
+    vector<int> frontier;
+    size_t cur = 0;
+    bool done = false, phaseDone = false;
+    atomic<size_t> cursor{0};
+    SpinBarrier bar(T);
+    buckets[0].resize(1);
+    buckets[0][0].push_back(src);
+
+    auto gather = [&](size_t b){
+        frontier.clear();
+        for(auto& local : buckets)
+            if(b < local.size()){
+                frontier.insert(frontier.end(), local[b].begin(), local[b].end());
+                local[b].clear();
+            }
+        cursor.store(0, memory_order_relaxed);
+    };
+    auto relax = [&](int t, int v, double nd){
+        if(atomic_min_double(&d[v], nd)){
+            size_t b = size_t(nd / delta);
+            if(b >= buckets[t].size()) buckets[t].resize(b + 1);
+            buckets[t][b].push_back(v);
+        }
+    };
+    auto worker = [&](int t){
+        while(true){
+            if(t == 0){
+                size_t last = 0;
+                for(auto& local : buckets) last = max(last, local.size());
+                while(cur < last){
+                    bool any = false;
+                    for(auto& local : buckets) if(cur < local.size() && !local[cur].empty()) any = true;
+                    if(any) break;
+                    ++cur;
+                }
+                done = cur >= last;
+                if(!done) gather(cur);
+            }
+            bar.wait();
+            if(done) break;
+            // light-edge phases until the bucket stops refilling
+            while(true){
+                for(size_t c; (c = cursor.fetch_add(64, memory_order_relaxed)) < frontier.size(); ){
+                    for(size_t i = c; i < min(c + 64, frontier.size()); ++i){
+                        int u = frontier[i];
+                        double du;
+                        __atomic_load(&d[u], &du, __ATOMIC_RELAXED);
+                        if(size_t(du / delta) != cur) continue; // stale entry
+                        settled[t].push_back(u);
+                        for(auto [v,w] : G.adj[u])
+                            if(w <= delta) relax(t, v, du + w);
+                    }
+                }
+                bar.wait();
+                if(t == 0){
+                    gather(cur);
+                    phaseDone = frontier.empty();
+                }
+                bar.wait();
+                if(phaseDone) break;
+            }
+            for(int u : settled[t]){
+                double du;
+                __atomic_load(&d[u], &du, __ATOMIC_RELAXED);
+                for(auto [v,w] : G.adj[u])
+                    if(w > delta) relax(t, v, du + w);
+            }
+            settled[t].clear();
+            bar.wait();
+            if(t == 0) ++cur;
+        }
+    };
+    vector<thread> pool;
+    for(int t = 1; t < T; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for(auto& th : pool) th.join();
+}
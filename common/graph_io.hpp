@@ -0,0 +1,382 @@
+// graph_io.hpp
+// Graph types, the input formats shared by the diameter drivers (MatrixMarket,
+// SNAP, METIS, GBIN, optionally .gz/.zst-compressed) and the parallel CSR
+// builder. Included by Crescenzi/Crescenzi.cpp, Crescenzi/PartitionedIFUB.cpp
+// and take_kosters/takes_kosters.cpp.
+#pragma once
+#include <bits/stdc++.h>
+#include <unistd.h>
+using namespace std;
+using Clock = chrono::high_resolution_clock;
+
+// ——— Graph definition and loader ———
+// Graphs are templated on the weight type: void for pattern matrices (no
+// weight storage at all), otherwise the narrowest type that holds every
+// weight exactly. Arcs bind as `auto [v, w]`; w reads as double whatever the
+// storage type, and is 1 for unweighted graphs.
+template<class W> struct Arc { uint32_t v; W w; };
+template<> struct Arc<void> { uint32_t v; };
+
+template<size_t I, class W> auto get(const Arc<W>& a){
+    if constexpr(I == 0) return (int)a.v;
+    else if constexpr(is_void_v<W>) return 1.0;
+    else return (double)a.w;
+}
+namespace std {
+template<class W> struct tuple_size<Arc<W>> : integral_constant<size_t, 2> {};
+template<size_t I, class W> struct tuple_element<I, Arc<W>> {
+    using type = decltype(get<I>(declval<Arc<W>>()));
+};
+}
+
+// Graph storage allocator; a driver that tracks allocations defines
+// GRAPH_ALLOC as a one-parameter allocator template before the include.
+#ifndef GRAPH_ALLOC
+#define GRAPH_ALLOC allocator
+#endif
+template<class T> using graph_vector = vector<T, GRAPH_ALLOC<T>>;
+
+template<class W>
+struct BasicGraph {
+    using Edge = Arc<W>;
+    static constexpr bool weighted = !is_void_v<W>;
+    int n;
+    graph_vector<graph_vector<Edge>> adj;
+    BasicGraph(int _n): n(_n), adj(n) {}
+    static Edge arc(int v, double w){
+        if constexpr(weighted) return {(uint32_t)v, (W)w};
+        else return {(uint32_t)v};
+    }
+    static bool before(const Edge& a, const Edge& b){
+        if constexpr(weighted) return a.v != b.v ? a.v < b.v : a.w < b.w;
+        else return a.v < b.v;
+    }
+};
+
+// Weight storage picked from the header and the values actually present.
+enum class WeightType { None, U32, F32, F64 };
+
+struct EdgeList {
+    int n = 0;
+    graph_vector<tuple<int,int,double>> edges;
+    WeightType type = WeightType::None;
+};
+
+// An all-ones weighted file is still unweighted; integer files that fit in
+// uint32 and real files whose values all round-trip through float get the
+// narrow types.
+inline WeightType narrowest_weight_type(const EdgeList& E, bool integer){
+    bool ones = true, u32 = integer, f32 = true;
+    for(auto& [u,v,w] : E.edges){
+        if(w != 1.0) ones = false;
+        if(u32 && (w < 0 || w > UINT32_MAX || w != floor(w))) u32 = false;
+        if(f32 && (double)(float)w != w) f32 = false;
+    }
+    if(ones) return WeightType::None;
+    if(u32)  return WeightType::U32;
+    if(f32)  return WeightType::F32;
+    return WeightType::F64;
+}
+
+// ——— Input streams ———
+// .gz and .zst/.zstd files are read from the stdout of `gzip -dc` / `zstd -dc`:
+// decompression runs in its own process, overlapped with parsing, and no
+// uncompressed copy ever reaches the disk. Other files are read directly.
+inline bool has_suffix(const string& s, const string& x){
+    return s.size() >= x.size() && s.compare(s.size() - x.size(), x.size(), x) == 0;
+}
+
+struct InputStream {
+    string path;
+    FILE*  f = nullptr;
+    bool   piped = false;
+    char*  buf = nullptr;
+    size_t cap = 0;
+
+    static string decompressor(const string& p){
+        if(has_suffix(p, ".gz")) return "gzip -dc";
+        if(has_suffix(p, ".zst") || has_suffix(p, ".zstd")) return "zstd -dc";
+        return "";
+    }
+    explicit InputStream(const string& p): path(p) {
+        string cmd = decompressor(p);
+        if(cmd.empty()) f = fopen(p.c_str(), "rb");
+        else if(access(p.c_str(), R_OK) == 0){
+            string quoted = "'";
+            for(char c : p) quoted += c == '\'' ? string("'\\''") : string(1, c);
+            f = popen((cmd + " " + quoted + "'").c_str(), "r");
+            piped = true;
+        }
+        if(!f) throw runtime_error("Cannot open "+p);
+    }
+    InputStream(const InputStream&) = delete;
+    ~InputStream(){
+        if(f) piped ? pclose(f) : fclose(f);
+        free(buf);
+    }
+    // Next line without its line terminator; false at end of input.
+    bool line(char*& s){
+        ssize_t r = getline(&buf, &cap, f);
+        if(r < 0) return false;
+        while(r > 0 && (buf[r-1] == '\n' || buf[r-1] == '\r')) buf[--r] = 0;
+        s = buf;
+        return true;
+    }
+    // Next line that is not a comment (first non-blank character in comments).
+    bool data_line(char*& s, const char* comments){
+        while(line(s)){
+            char* p = s;
+            while(*p == ' ' || *p == '\t') ++p;
+            if(!*p || !strchr(comments, *p)) return true;
+        }
+        return false;
+    }
+    bool read(void* dst, size_t bytes){ return fread(dst, 1, bytes, f) == bytes; }
+    // Closes the stream; a failing decompressor means a corrupt or truncated archive.
+    void finish(){
+        if(!f) return;
+        int status = piped ? pclose(f) : fclose(f);
+        f = nullptr;
+        if(piped && status != 0) throw runtime_error("Decompressing " + path + " failed");
+    }
+};
+
+inline EdgeList load_mm_edges(const string& path){
+    InputStream in(path);
+    char* s;
+    if(!in.line(s) || strncmp(s, "%%MatrixMarket", 14) != 0)
+        throw runtime_error("Not a MatrixMarket file");
+    string header = s;
+
+    bool is_pattern  = header.find("pattern") != string::npos;
+    bool is_integer  = header.find("integer") != string::npos;
+    bool is_weighted = !is_pattern
+                    && (header.find("real")    != string::npos
+                     || header.find("complex") != string::npos
+                     || is_integer);
+    if(!in.data_line(s, "%")) throw runtime_error("Truncated MatrixMarket file");
+    int M = 0, N = 0; long long L = 0;
+    if(sscanf(s, "%d %d %lld", &M, &N, &L) != 3) throw runtime_error("Bad MatrixMarket size line");
+    if(M!=N) throw runtime_error("Only square graphs supported");
+    EdgeList E;
+    E.n = M;
+    E.edges.reserve(L);
+    while((long long)E.edges.size() < L && in.data_line(s, "%")){
+        char* p = s;
+        long u = strtol(p, &p, 10), v = strtol(p, &p, 10);
+        if(p == s) continue; // blank line
+        if(u < 1 || u > M || v < 1 || v > M) throw runtime_error("Vertex id out of range in "+path);
+        double w = is_weighted ? strtod(p, &p) : 1.0; // complex: real part
+        E.edges.emplace_back(u-1,v-1,w);
+    }
+    if((long long)E.edges.size() < L) throw runtime_error("Truncated MatrixMarket file");
+    in.finish();
+    if(is_weighted) E.type = narrowest_weight_type(E, is_integer);
+    return E;
+}
+
+// SNAP-style edge list: one "u v" or "u v w" per line, '#' or '%' comments.
+// Vertex ids may be sparse and start anywhere; they are renumbered 0..n-1 in
+// increasing order so that unused ids do not become isolated vertices. The
+// renumbering sorts the ids that occur, so its memory does not depend on the
+// largest id.
+inline EdgeList load_snap_edges(const string& path){
+    InputStream in(path);
+    EdgeList E;
+    bool weighted = false;
+    char* s;
+    while(in.data_line(s, "#%")){
+        char* p = s;
+        long u = strtol(p, &p, 10);
+        if(p == s) continue;
+        char* q = p;
+        long v = strtol(q, &q, 10);
+        if(q == p) throw runtime_error("Bad edge line in "+path+": "+s);
+        if(u < 0 || v < 0 || u > INT_MAX || v > INT_MAX) throw runtime_error("Vertex id out of range in "+path);
+        char* r = q;
+        double w = strtod(r, &r);
+        if(r == q) w = 1.0; else weighted = true;
+        E.edges.emplace_back(u, v, w);
+    }
+    in.finish();
+    // the sorted distinct ids; a vertex's new id is its rank among them
+    vector<int> ids;
+    ids.reserve(2 * E.edges.size());
+    for(auto& [u,v,w] : E.edges){ ids.push_back(u); ids.push_back(v); }
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    E.n = ids.size();
+    auto rank = [&](int x){ return int(lower_bound(ids.begin(), ids.end(), x) - ids.begin()); };
+    for(auto& [u,v,w] : E.edges){ u = rank(u); v = rank(v); }
+    if(weighted) E.type = narrowest_weight_type(E, true);
+    return E;
+}
+
+// METIS / DIMACS10 .graph: "n m [fmt [ncon]]", then one line per vertex
+// listing its 1-based neighbours (each edge appears in both lists, so only
+// u <= v is kept; self-loops are left for build_graph to drop and count).
+// fmt digits: vertex sizes, vertex weights, edge weights; the first two are
+// skipped. Blank lines are isolated vertices.
+inline EdgeList load_metis_edges(const string& path){
+    InputStream in(path);
+    char* s;
+    if(!in.data_line(s, "%")) throw runtime_error("Empty METIS file");
+    long long n = 0, m = 0; int fmt = 0, ncon = 1;
+    if(sscanf(s, "%lld %lld %d %d", &n, &m, &fmt, &ncon) < 2) throw runtime_error("Bad METIS header");
+    if(n > INT_MAX) throw runtime_error("Graph too large for int vertex ids");
+    bool edgeW = fmt % 10, vertW = fmt / 10 % 10, vertS = fmt / 100 % 10;
+    EdgeList E;
+    E.n = (int)n;
+    E.edges.reserve(m);
+    for(int u = 0; u < E.n; ++u){
+        if(!in.data_line(s, "%")) throw runtime_error("Truncated METIS file");
+        char* p = s;
+        for(int k = (vertS ? 1 : 0) + (vertW ? ncon : 0); k > 0; --k) strtol(p, &p, 10);
+        while(true){
+            char* q = p;
+            long v = strtol(q, &q, 10);
+            if(q == p) break;
+            p = q;
+            double w = edgeW ? strtod(p, &p) : 1.0;
+            if(v < 1 || v > n) throw runtime_error("Neighbour out of range in "+path);
+            if(u <= v - 1) E.edges.emplace_back(u, v-1, w);
+        }
+    }
+    in.finish();
+    if(edgeW) E.type = narrowest_weight_type(E, true);
+    return E;
+}
+
+// Binary edge list written by Generator/graph_gen: "GBIN", uint32 version,
+// uint64 n, uint64 m, then m (u,v) pairs of 0-based uint32 vertex ids.
+inline EdgeList load_gbin_edges(const string& path){
+    InputStream in(path);
+    char magic[4]; uint32_t version; uint64_t n, m;
+    if(!in.read(magic, 4) || !in.read(&version, 4) || !in.read(&n, 8) || !in.read(&m, 8)
+       || memcmp(magic, "GBIN", 4) != 0) throw runtime_error("Not a GBIN file");
+    if(n > (uint64_t)INT_MAX) throw runtime_error("Graph too large for int vertex ids");
+    EdgeList E;
+    E.n = (int)n;
+    E.edges.reserve(m);
+    vector<uint32_t> buf(1 << 20);
+    for(uint64_t done = 0; done < m; ){
+        size_t k = min<uint64_t>(buf.size() / 2, m - done);
+        if(!in.read(buf.data(), k * 8)) throw runtime_error("Truncated GBIN file");
+        for(size_t i = 0; i < k; ++i){
+            if(buf[2*i] >= n || buf[2*i+1] >= n) throw runtime_error("Vertex id out of range in "+path);
+            E.edges.emplace_back(buf[2*i], buf[2*i+1], 1.0);
+        }
+        done += k;
+    }
+    in.finish();
+    return E;
+}
+
+// Format from the extension, after any .gz/.zst suffix: .gbin, .graph/.metis,
+// .txt/.edges/.el/.snap (SNAP); anything else is MatrixMarket.
+inline EdgeList load_edges(const string& path){
+    string base = path;
+    if(!InputStream::decompressor(path).empty()) base = path.substr(0, path.rfind('.'));
+    if(has_suffix(base, ".gbin")) return load_gbin_edges(path);
+    if(has_suffix(base, ".graph") || has_suffix(base, ".metis")) return load_metis_edges(path);
+    for(const char* ext : {".txt", ".edges", ".el", ".snap"})
+        if(has_suffix(base, ext)) return load_snap_edges(path);
+    return load_mm_edges(path);
+}
+
+// ——— Graph construction ———
+// Arcs are counting-sorted by source on BUILD.threads threads (atomic degree
+// counts, then an atomic scatter), and each adjacency list is then sorted and
+// deduplicated. Self-loops are dropped, and a pair listed more than once
+// (e.g. as both (u,v) and (v,u) in a `general` file) keeps a single arc with
+// its smallest weight, so BFS never scans the same neighbour twice.
+struct GraphBuild {
+    int       threads = max(1u, thread::hardware_concurrency());
+    long long edges = 0, selfLoops = 0, duplicates = 0; // input edges, removed edges
+    double    seconds = 0;
+
+    void report(ostream& out) const {
+        out << "# build: edges=" << edges << " self_loops_removed=" << selfLoops
+            << " duplicates_removed=" << duplicates << " seconds=" << seconds << "\n";
+    }
+};
+inline GraphBuild BUILD;
+
+// f(t, lo, hi) on T threads over [0, n) split evenly.
+template<class F>
+void build_chunks(size_t n, int T, F&& f){
+    if(T <= 1){ f(0, size_t(0), n); return; }
+    vector<thread> pool;
+    for(int t = 0; t < T; ++t) pool.emplace_back([&, t]{ f(t, n * t / T, n * (t + 1) / T); });
+    for(auto& th : pool) th.join();
+}
+
+template<class W>
+BasicGraph<W> build_graph(EdgeList& E){
+    using Edge = typename BasicGraph<W>::Edge;
+    auto t0 = Clock::now();
+    const int n = E.n;
+    const size_t m = E.edges.size();
+    const int T = (int)max<size_t>(1, min<size_t>(BUILD.threads, m / 65536));
+    vector<long long> loops(T, 0), dups(T, 0);
+
+    graph_vector<int64_t> start(n + 1, 0);
+    build_chunks(m, T, [&](int t, size_t lo, size_t hi){
+        for(size_t i = lo; i < hi; ++i){
+            auto& [u,v,w] = E.edges[i];
+            if(u == v){ loops[t]++; continue; }
+            __atomic_fetch_add(&start[u+1], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&start[v+1], 1, __ATOMIC_RELAXED);
+        }
+    });
+    for(int v = 0; v < n; ++v) start[v+1] += start[v];
+    graph_vector<int64_t> pos(start.begin(), start.end() - 1);
+    graph_vector<Edge> arcs(start[n]);
+    build_chunks(m, T, [&](int, size_t lo, size_t hi){
+        for(size_t i = lo; i < hi; ++i){
+            auto& [u,v,w] = E.edges[i];
+            if(u == v) continue;
+            arcs[__atomic_fetch_add(&pos[u], 1, __ATOMIC_RELAXED)] = BasicGraph<W>::arc(v, w);
+            arcs[__atomic_fetch_add(&pos[v], 1, __ATOMIC_RELAXED)] = BasicGraph<W>::arc(u, w);
+        }
+    });
+    E.edges.clear();
+    E.edges.shrink_to_fit();
+    pos.clear();
+    pos.shrink_to_fit();
+
+    // vertex chunks hold about the same number of arcs
+    BasicGraph<W> G(n);
+    build_chunks(T, T, [&](int t, size_t, size_t){
+        int lo = lower_bound(start.begin(), start.end() - 1, (int64_t)arcs.size() * t / T) - start.begin();
+        int hi = lower_bound(start.begin(), start.end() - 1, (int64_t)arcs.size() * (t + 1) / T) - start.begin();
+        if(t == T - 1) hi = n;
+        for(int v = lo; v < hi; ++v){
+            auto first = arcs.begin() + start[v], last = arcs.begin() + start[v+1];
+            sort(first, last, BasicGraph<W>::before);
+            auto end = unique(first, last, [](const Edge& a, const Edge& b){ return a.v == b.v; });
+            dups[t] += last - end;
+            G.adj[v].assign(first, end);
+        }
+    });
+
+    BUILD.edges = m;
+    BUILD.selfLoops = accumulate(loops.begin(), loops.end(), 0LL);
+    BUILD.duplicates = accumulate(dups.begin(), dups.end(), 0LL) / 2;
+    BUILD.seconds = chrono::duration<double>(Clock::now() - t0).count();
+    return G;
+}
+
+// Loads path and calls f with the graph instantiated for its weight type; the
+// only runtime dispatch, everything below f is compiled per type.
+template<class F>
+int with_graph(const string& path, F&& f){
+    EdgeList E = load_edges(path);
+    switch(E.type){
+        case WeightType::None: return f(build_graph<void>(E));
+        case WeightType::U32:  return f(build_graph<uint32_t>(E));
+        case WeightType::F32:  return f(build_graph<float>(E));
+        default:               return f(build_graph<double>(E));
+    }
+}
+
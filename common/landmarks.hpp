@@ -0,0 +1,125 @@
+// landmarks.hpp
+// BFS distance arrays kept as landmarks (--landmarks) and the reader used by
+// take_kosters/landmark_query.
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+// ——— Landmarks (--landmarks file) ———
+// Keeps the distance arrays of up to --landmark-count of the run's BFS and
+// writes them to file for landmark_query, so later distance queries reuse
+// BFS work the diameter computation has already done. Each array is stored
+// at the narrowest width its distances fit (1, 2 or 4 bytes; the maximum
+// value marks unreached vertices). Once the set is full, a new source
+// replaces the landmark nearest to another landmark if it lies farther than
+// that from all of them, which keeps the sources spread over the graph.
+// LANDMARK_ALLOC selects the storage allocator, like GRAPH_ALLOC in
+// graph_io.hpp.
+#ifndef LANDMARK_ALLOC
+#define LANDMARK_ALLOC allocator
+#endif
+
+struct Landmark {
+    int src = -1, ecc = 0, width = 1;
+    vector<uint8_t, LANDMARK_ALLOC<uint8_t>> data;
+    int at(int v) const {
+        if(width == 1) return data[v] == UINT8_MAX ? INT_MAX : data[v];
+        if(width == 2){
+            uint16_t x; memcpy(&x, &data[2 * (size_t)v], 2);
+            return x == UINT16_MAX ? INT_MAX : x;
+        }
+        int x; memcpy(&x, &data[4 * (size_t)v], 4);
+        return x;
+    }
+};
+
+struct LandmarkSet {
+    string path;
+    int k = 16;
+    mutex mu;
+    vector<Landmark> kept;
+    vector<int> nearest; // per landmark: distance to the closest other one
+    bool enabled() const { return !path.empty(); }
+
+    // dist may be any width; its maximum value marks unreached vertices.
+    template<class Dist>
+    void offer(int src, const Dist& dist){
+        if(!enabled()) return;
+        const auto unreached = numeric_limits<typename Dist::value_type>::max();
+        lock_guard<mutex> lk(mu);
+        int far = INT_MAX;
+        for(auto& l : kept){
+            if(l.src == src) return;
+            far = min(far, l.at(src));
+        }
+        size_t slot = kept.size();
+        if((int)slot >= k){
+            slot = min_element(nearest.begin(), nearest.end()) - nearest.begin();
+            if(far <= nearest[slot]) return;
+        } else kept.emplace_back();
+        Landmark& l = kept[slot];
+        const size_t n = dist.size();
+        l.src = src;
+        l.ecc = 0;
+        for(size_t v = 0; v < n; ++v) if(dist[v] != unreached) l.ecc = max<int>(l.ecc, dist[v]);
+        l.width = l.ecc < UINT8_MAX ? 1 : l.ecc < UINT16_MAX ? 2 : 4;
+        l.data.assign(n * l.width, 0);
+        for(size_t v = 0; v < n; ++v){
+            bool r = dist[v] != unreached;
+            if(l.width == 1) l.data[v] = r ? uint8_t(dist[v]) : UINT8_MAX;
+            else if(l.width == 2){
+                uint16_t x = r ? uint16_t(dist[v]) : UINT16_MAX;
+                memcpy(&l.data[2 * v], &x, 2);
+            } else {
+                int x = r ? int(dist[v]) : INT_MAX;
+                memcpy(&l.data[4 * v], &x, 4);
+            }
+        }
+        nearest.assign(kept.size(), INT_MAX);
+        for(size_t i = 0; i < kept.size(); ++i)
+            for(size_t j = 0; j < kept.size(); ++j)
+                if(i != j) nearest[i] = min(nearest[i], kept[j].at(kept[i].src));
+    }
+
+    // "LMRK", uint32 version, int32 n, int32 count, then per landmark int32
+    // src, ecc, width and n values of width bytes.
+    void write(int n) const {
+        ofstream out(path, ios::binary);
+        if(!out) throw runtime_error("Cannot write "+path);
+        auto put = [&](auto x){ out.write((const char*)&x, sizeof(x)); };
+        out.write("LMRK", 4);
+        put(uint32_t(1));
+        put(int32_t(n));
+        put(int32_t(kept.size()));
+        for(auto& l : kept){
+            put(int32_t(l.src)); put(int32_t(l.ecc)); put(int32_t(l.width));
+            out.write((const char*)l.data.data(), l.data.size());
+        }
+        if(!out) throw runtime_error("Cannot write "+path);
+    }
+
+    // Replaces kept with the landmarks in path; returns n.
+    int read(){
+        ifstream in(path, ios::binary);
+        if(!in) throw runtime_error("Cannot open "+path);
+        auto get = [&]{ int32_t x = 0; in.read((char*)&x, 4); return x; };
+        char magic[4];
+        in.read(magic, 4);
+        if(!in || memcmp(magic, "LMRK", 4) != 0) throw runtime_error("Not a landmark file");
+        if(get() != 1) throw runtime_error("Unsupported landmark file version");
+        int n = get(), count = get();
+        if(!in || n < 0 || count < 0) throw runtime_error("Bad landmark file header");
+        kept.assign(count, Landmark());
+        for(auto& l : kept){
+            l.src = get();
+            l.ecc = get();
+            l.width = get();
+            if(l.width != 1 && l.width != 2 && l.width != 4) throw runtime_error("Bad landmark width");
+            l.data.resize((size_t)n * l.width);
+            in.read((char*)l.data.data(), l.data.size());
+            if(!in) throw runtime_error("Truncated landmark file");
+        }
+        return n;
+    }
+};
+inline LandmarkSet LANDMARKS;
@@ -0,0 +1,110 @@
+// parallel_bfs.hpp
+// Level-synchronous parallel BFS shared by the diameter drivers.
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+// ——— Level-synchronous parallel BFS ———
+// Used by the BFS kernels once G.n reaches PAR_BFS.threshold. Each thread owns
+// a contiguous block of the current frontier and claims CHUNK-sized pieces of
+// it through an atomic cursor; once its block is empty it steals chunks from
+// the other blocks. Discovered vertices go to thread-local next-frontier
+// buffers and are claimed with a CAS on dist, so each vertex is enqueued
+// exactly once. Next-frontier buffers are allocated and first touched by
+// their owning thread, so under the default first-touch policy they live on
+// that thread's NUMA node; dist is reset slice-by-slice by the same threads.
+struct ParBfsConfig {
+    int       threads   = max(1u, thread::hardware_concurrency());
+    long long threshold = 1 << 20; // vertices; below this BFS stays sequential
+};
+inline ParBfsConfig PAR_BFS;
+
+template<class Graph>
+bool use_parallel_bfs(const Graph& G){
+    return PAR_BFS.threads > 1 && G.n >= PAR_BFS.threshold;
+}
+
+struct SpinBarrier {
+    const int n;
+    atomic<int> count{0}, gen{0};
+    SpinBarrier(int _n): n(_n) {}
+    void wait(){
+        int g = gen.load(memory_order_acquire);
+        if(count.fetch_add(1, memory_order_acq_rel) + 1 == n){
+            count.store(0, memory_order_relaxed);
+            gen.fetch_add(1, memory_order_release);
+        } else {
+            while(gen.load(memory_order_acquire) == g) this_thread::yield();
+        }
+    }
+};
+
+// Fills dist (INT_MAX = unreached) and returns the eccentricity of src.
+template<class Graph, class Dist>
+int parallel_bfs(const Graph& G, int src, Dist& dist){
+    const int T = PAR_BFS.threads;
+    const size_t CHUNK = 256;
+    dist.resize(G.n);
+    int* d = dist.data();
+    vector<int> frontier, offset(T + 1);
+    vector<vector<int>> next(T);
+    vector<atomic<size_t>> cursor(T);
+    vector<size_t> blockEnd(T);
+    int level = 0;
+    bool done = false;
+    SpinBarrier bar(T);
+
+    auto worker = [&](int t){
+        for(size_t i = size_t(G.n) * t / T; i < size_t(G.n) * (t + 1) / T; ++i) d[i] = INT_MAX;
+        next[t].reserve(1024);
+        bar.wait();
+        if(t == 0){
+            d[src] = 0;
+            frontier.assign(1, src);
+        }
+        while(true){
+            if(t == 0){
+                for(int b = 0; b < T; ++b){
+                    cursor[b].store(frontier.size() * b / T, memory_order_relaxed);
+                    blockEnd[b] = frontier.size() * (b + 1) / T;
+                }
+            }
+            bar.wait();
+            // own block first, then steal from the others
+            for(int k = 0; k < T; ++k){
+                int b = (t + k) % T;
+                for(size_t c; (c = cursor[b].fetch_add(CHUNK, memory_order_relaxed)) < blockEnd[b]; ){
+                    for(size_t i = c; i < min(c + CHUNK, blockEnd[b]); ++i){
+                        int u = frontier[i];
+                        for(auto [v,_w]: G.adj[u]){
+                            if(__atomic_load_n(&d[v], __ATOMIC_RELAXED) != INT_MAX) continue;
+                            int expected = INT_MAX;
+                            if(__atomic_compare_exchange_n(&d[v], &expected, level + 1, false,
+                                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                                next[t].push_back(v);
+                        }
+                    }
+                }
+            }
+            bar.wait();
+            if(t == 0){
+                for(int i = 0; i < T; ++i) offset[i + 1] = offset[i] + next[i].size();
+                done = offset[T] == 0;
+                if(!done){
+                    frontier.resize(offset[T]);
+                    ++level;
+                }
+            }
+            bar.wait();
+            if(done) break;
+            copy(next[t].begin(), next[t].end(), frontier.begin() + offset[t]);
+            next[t].clear();
+            bar.wait();
+        }
+    };
+    vector<thread> pool;
+    for(int t = 1; t < T; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for(auto& th : pool) th.join();
+    return level;
+}
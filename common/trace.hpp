@@ -0,0 +1,115 @@
+// trace.hpp
+// Runtime-switchable phase tracing and per-BFS telemetry (--trace).
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+using Clock = chrono::high_resolution_clock;
+
+// ——— Tracing (Chrome trace-event JSON) ———
+// Disabled by default; every hook checks TRACE.enabled first so an untraced
+// run only pays for a branch. Per-BFS statistics are derived from the final
+// dist array, which keeps the BFS inner loops untouched.
+struct TraceEvent {
+    string name;
+    char   ph;        // 'X' complete event, 'C' counter
+    double ts, dur;   // microseconds since trace start
+    string args;      // pre-rendered JSON object body
+};
+struct BfsRecord {
+    string      kind;
+    int         src = 0, ecc = 0;
+    long long   vertices = 0, edges = 0;
+    vector<int> frontier; // vertices per BFS level
+    double      ts = 0, dur = 0;
+};
+struct Tracer {
+    bool enabled = false;
+    Clock::time_point origin = Clock::now();
+    mutex mu;
+    vector<TraceEvent> events;
+    vector<BfsRecord>  bfs;
+
+    double now() const {
+        return chrono::duration<double, micro>(Clock::now() - origin).count();
+    }
+    void phase(const string& name, double ts, double dur, const string& args = ""){
+        lock_guard<mutex> lk(mu);
+        events.push_back({name, 'X', ts, dur, args});
+    }
+    void counter(const string& name, const string& args){
+        double ts = now();
+        lock_guard<mutex> lk(mu);
+        events.push_back({name, 'C', ts, 0, args});
+    }
+    // dist may be any width; its maximum value marks unreached vertices.
+    template<class Graph, class Dist>
+    void record_bfs(const Graph& G, const string& kind, int src,
+                    const Dist& dist, double ts){
+        const auto unreached = numeric_limits<typename Dist::value_type>::max();
+        BfsRecord r;
+        r.kind = kind; r.src = src;
+        r.ts = ts; r.dur = now() - ts;
+        for(int v = 0; v < G.n; ++v){
+            if(dist[v] == unreached) continue;
+            int d = dist[v];
+            r.vertices++;
+            r.edges += G.adj[v].size();
+            if(d >= (int)r.frontier.size()) r.frontier.resize(d + 1);
+            r.frontier[d]++;
+            r.ecc = max(r.ecc, d);
+        }
+        lock_guard<mutex> lk(mu);
+        bfs.push_back(move(r));
+    }
+    void write_json(const string& path){
+        ofstream out(path);
+        if(!out) throw runtime_error("Cannot write "+path);
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        auto sep = [&]{ if(!first) out << ",\n"; first = false; };
+        for(auto& e : events){
+            sep();
+            out << "{\"name\":\"" << e.name << "\",\"ph\":\"" << e.ph
+                << "\",\"ts\":" << fixed << setprecision(3) << e.ts;
+            if(e.ph == 'X') out << ",\"dur\":" << e.dur;
+            out << ",\"pid\":0,\"tid\":0,\"args\":{" << e.args << "}}";
+        }
+        for(auto& r : bfs){
+            sep();
+            out << "{\"name\":\"bfs:" << r.kind << "\",\"ph\":\"X\",\"ts\":"
+                << r.ts << ",\"dur\":" << r.dur << ",\"pid\":0,\"tid\":1,\"args\":{"
+                << "\"src\":" << r.src << ",\"ecc\":" << r.ecc
+                << ",\"vertices\":" << r.vertices << ",\"edges\":" << r.edges
+                << ",\"frontier\":[";
+            for(size_t i = 0; i < r.frontier.size(); ++i)
+                out << (i ? "," : "") << r.frontier[i];
+            out << "]}}";
+        }
+        out << "\n]}\n";
+    }
+    // Phase totals plus a log2 histogram of BFS durations.
+    void print_summary(ostream& os){
+        map<string, pair<int,double>> totals;
+        for(auto& e : events) if(e.ph == 'X'){
+            totals[e.name].first++;
+            totals[e.name].second += e.dur;
+        }
+        os << "# phase,count,total_ms\n";
+        for(auto& [name, t] : totals)
+            os << name << "," << t.first << "," << t.second / 1000.0 << "\n";
+        map<int,int> hist;
+        for(auto& r : bfs) hist[r.dur < 1 ? 0 : (int)log2(r.dur)]++;
+        os << "# bfs_duration_us,count\n";
+        for(auto& [b, c] : hist)
+            os << "[" << (b ? (1LL << b) : 0) << "," << (1LL << (b + 1)) << ")," << c << "\n";
+    }
+};
+inline Tracer TRACE;
+
+// RAII phase timer; a no-op unless tracing is on.
+struct TraceScope {
+    const char* name;
+    double ts = 0;
+    TraceScope(const char* _name): name(_name) { if(TRACE.enabled) ts = TRACE.now(); }
+    ~TraceScope(){ if(TRACE.enabled) TRACE.phase(name, ts, TRACE.now() - ts); }
+};
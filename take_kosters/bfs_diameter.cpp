@@ -3,43 +3,29 @@
 using namespace std;
 using Clock = chrono::high_resolution_clock;
 
+#include "../common/graph_io.hpp"
+#include "../common/delta_stepping.hpp"
+
 // Reuse Graph definition from takes_kosters.cpp
-using Edge = tuple<int,int,double>;
+using Edge = pair<int,double>; // (neighbour, weight)
 struct Graph {
     int n;
     vector<vector<Edge>> adj;
     bool weighted = false;
     Graph(int _n): n(_n), adj(n) {}
     void add_edge(int u,int v,double w=1.0){
-        adj[u].emplace_back(u,v,w);
-        adj[v].emplace_back(v,u,w);
+        adj[u].emplace_back(v,w);
+        adj[v].emplace_back(u,w);
         if(w!=1.0) weighted = true;
     }
 };
 
-// Reuse graph loader from takes_kosters.cpp
-Graph load_mm_graph(const string& path){
-    ifstream in(path);
-    if(!in) throw runtime_error("Cannot open "+path);
-    string header; getline(in, header);
-    if(header.rfind("%%MatrixMarket",0)!=0)
-        throw runtime_error("Not a MatrixMarket file");
-    bool is_pattern  = header.find("pattern")!=string::npos;
-    bool is_weighted = !is_pattern
-                    && (header.find("real")   != string::npos
-                     || header.find("integer")!= string::npos);
-    string line;
-    while(getline(in,line) && line.size() && line[0]=='%');
-    istringstream iss(line);
-    int M,N,L; iss>>M>>N>>L;
-    if(M!=N) throw runtime_error("Only square graphs supported");
-    Graph G(M);
-    for(int i=0;i<L;i++){
-        int u,v; double w=1.0;
-        in>>u>>v;
-        if(is_weighted) in>>w;
-        G.add_edge(u-1,v-1,w);
-    }
+// Any format of common/graph_io.hpp: .mtx, .gbin (Generator/graph_gen), SNAP
+// edge lists and METIS graphs, optionally .gz/.zst-compressed.
+Graph load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    Graph G(E.n);
+    for(auto& [u,v,w] : E.edges) G.add_edge(u, v, w);
     return G;
 }
 
@@ -51,7 +37,7 @@ int computeEccentricity(const Graph& G, int src, vector<int>& dist) {
         dist[src]=0; q.push(src);
         while(!q.empty()){
             int u=q.front(); q.pop();
-            for(auto [_,v,w]: G.adj[u]){
+            for(auto [v,w]: G.adj[u]){
                 if(dist[v]==INT_MAX){
                     dist[v] = dist[u]+1;
                     q.push(v);
@@ -61,15 +47,18 @@ int computeEccentricity(const Graph& G, int src, vector<int>& dist) {
     } else {
         using P = pair<double,int>;
         vector<double> d(G.n,1e30);
-        priority_queue<P,vector<P>,greater<P>> pq;
-        d[src]=0; pq.emplace(0,src);
-        while(!pq.empty()){
-            auto [du,u] = pq.top(); pq.pop();
-            if(du> d[u]) continue;
-            for(auto [_,v,w]: G.adj[u]){
-                if(du + w < d[v]){
-                    d[v] = du + w;
-                    pq.emplace(d[v],v);
+        if(DELTA.enabled) delta_stepping(G, src, d);
+        else {
+            priority_queue<P,vector<P>,greater<P>> pq;
+            d[src]=0; pq.emplace(0,src);
+            while(!pq.empty()){
+                auto [du,u] = pq.top(); pq.pop();
+                if(du> d[u]) continue;
+                for(auto [v,w]: G.adj[u]){
+                    if(du + w < d[v]){
+                        d[v] = du + w;
+                        pq.emplace(d[v],v);
+                    }
                 }
             }
         }
@@ -102,12 +91,23 @@ int computeDiameter(const Graph& G) {
 }
 
 int main(int argc, char* argv[]) {
-    if(argc != 2) {
-        cerr << "Usage: " << argv[0] << " graph.mtx\n";
+    if(argc < 2 || argc % 2 != 0) {
+        cerr << "Usage: " << argv[0] << " graph.mtx [--sssp dijkstra|delta] [--delta D] [--threads T]\n";
         return 1;
     }
+    for(int i = 2; i + 1 < argc; i += 2){
+        string flag = argv[i];
+        if(flag == "--sssp") DELTA.enabled = string(argv[i+1]) == "delta";
+        else if(flag == "--delta"){
+            DELTA.delta = stod(argv[i+1]);
+            if(!(DELTA.delta > 0)){ cerr << "--delta must be positive\n"; return 1; }
+        }
+        else if(flag == "--threads") DELTA.threads = max(1, stoi(argv[i+1]));
+        else { cerr << "Unknown option " << flag << "\n"; return 1; }
+    }
 
-    Graph G = load_mm_graph(argv[1]);
+    Graph G = load_graph(argv[1]);
+    if(DELTA.enabled && DELTA.delta <= 0) DELTA.delta = auto_delta(G);
     cout << "Computing diameter for graph with " << G.n << " vertices...\n";
     
     int diameter = computeDiameter(G);
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+diameter.py
+
+In-process bindings for BoundingDiameters (takes_kosters.cpp) and iFUB
+(../Crescenzi/Crescenzi.cpp) through ctypes. A Graph is loaded once and stays
+resident in the C++ library between calls; iteration logs and eccentricity
+bounds come back as NumPy arrays that view the C++ buffers without copying.
+
+Build the libraries first:
+    g++ -O3 -std=c++17 -pthread -shared -fPIC -DDIAMETER_LIB takes_kosters.cpp -o libbounding.so
+    g++ -O3 -std=c++17 -pthread -shared -fPIC -DDIAMETER_LIB ../Crescenzi/Crescenzi.cpp -o ../Crescenzi/libifub.so
+
+Usage:
+    import diameter
+    g = diameter.Graph("../Dataset/cs4.mtx")
+    r = g.bounding_diameters(strategy=1)
+    r.diameter, r.ecc_calls, r.log          # log: iterations x 6 int32
+    r.ecc_lower, r.ecc_upper                # per-vertex int32 bounds
+    g.ifub(strategy=1, seed=0)              # {"diameter": ..., "root": ..., ...}
+"""
+import ctypes
+import os
+import numpy as np
+
+_HERE = os.path.dirname(os.path.abspath(__file__))
+LOG_COLUMNS = ["iter", "|W|", "DeltaL", "DeltaU", "Batch", "Propagated"]
+
+_libs = {}
+
+def _lib(name):
+    """Load libbounding.so / libifub.so once and declare their signatures."""
+    if name in _libs:
+        return _libs[name]
+    if name == "bd":
+        lib = ctypes.CDLL(os.path.join(_HERE, "libbounding.so"))
+        lib.bd_run.argtypes = [ctypes.c_void_p] + [ctypes.c_int] * 5
+        lib.bd_run.restype = ctypes.c_void_p
+        for f in ("bd_diameter", "bd_upper_bound"):
+            getattr(lib, f).restype = ctypes.c_longlong
+        lib.bd_time.restype = ctypes.c_double
+        lib.bd_log.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_longlong)]
+        lib.bd_log.restype = ctypes.c_void_p
+        for f in ("bd_ecc_lower", "bd_ecc_upper"):
+            getattr(lib, f).restype = ctypes.c_void_p
+        for f in ("bd_diameter", "bd_upper_bound", "bd_ecc_calls", "bd_pruned",
+                  "bd_time", "bd_ecc_lower", "bd_ecc_upper", "bd_free_result"):
+            getattr(lib, f).argtypes = [ctypes.c_void_p]
+    else:
+        lib = ctypes.CDLL(os.path.join(_HERE, "..", "Crescenzi", "libifub.so"))
+        lib.ifub_run.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_uint32,
+                                 ctypes.c_int, ctypes.POINTER(ctypes.c_double)]
+    p = name if name == "bd" else "ifub"
+    getattr(lib, p + "_load").argtypes = [ctypes.c_char_p]
+    getattr(lib, p + "_load").restype = ctypes.c_void_p
+    getattr(lib, p + "_error").restype = ctypes.c_char_p
+    getattr(lib, p + "_arcs").restype = ctypes.c_longlong
+    for f in ("_free_graph", "_vertices", "_arcs", "_weighted"):
+        getattr(lib, p + f).argtypes = [ctypes.c_void_p]
+    _libs[name] = lib
+    return lib
+
+def _check(handle, lib, prefix):
+    if not handle:
+        raise RuntimeError(getattr(lib, prefix + "_error")().decode())
+    return handle
+
+class _View:
+    """Exposes a C++ buffer to NumPy; keeps its owner alive while viewed."""
+    def __init__(self, owner, ptr, shape, typestr):
+        self._owner = owner
+        self.__array_interface__ = {"data": (ptr, True), "shape": shape,
+                                    "typestr": typestr, "version": 3}
+
+def _view(owner, ptr, shape, typestr):
+    if not ptr or 0 in shape:
+        return np.zeros(shape, dtype=typestr)
+    return np.asarray(_View(owner, ptr, shape, typestr))
+
+class _Result:
+    """Owns a RunStats in libbounding.so; freed once no array views it."""
+    def __init__(self, lib, handle):
+        self._lib, self._h = lib, handle
+    def __del__(self):
+        self._lib.bd_free_result(self._h)
+
+class BDResult:
+    def __init__(self, lib, handle, n):
+        owner = _Result(lib, handle)
+        self.diameter    = lib.bd_diameter(handle)
+        self.upper_bound = lib.bd_upper_bound(handle)
+        self.ecc_calls   = lib.bd_ecc_calls(handle)
+        self.pruned      = lib.bd_pruned(handle)
+        self.time        = lib.bd_time(handle)
+        rows = ctypes.c_longlong()
+        ptr = lib.bd_log(handle, ctypes.byref(rows))
+        self.log = _view(owner, ptr, (rows.value, len(LOG_COLUMNS)), "<i4")
+        # INT_MAX in ecc_upper: no bound known
+        self.ecc_lower = _view(owner, lib.bd_ecc_lower(handle), (n,), "<i4")
+        self.ecc_upper = _view(owner, lib.bd_ecc_upper(handle), (n,), "<i4")
+
+class Graph:
+    """A graph file loaded on first use by each library, then kept resident."""
+    def __init__(self, path):
+        self.path = path
+        self._h = {}
+        self._load("bd")
+
+    def _load(self, name):
+        if name not in self._h:
+            lib = _lib(name)
+            prefix = "bd" if name == "bd" else "ifub"
+            self._h[name] = (lib, _check(getattr(lib, prefix + "_load")(self.path.encode()), lib, prefix))
+        return self._h[name]
+
+    def __del__(self):
+        for name, (lib, h) in self._h.items():
+            getattr(lib, ("bd" if name == "bd" else "ifub") + "_free_graph")(h)
+
+    @property
+    def n(self):
+        lib, h = self._load("bd")
+        return lib.bd_vertices(h)
+
+    @property
+    def arcs(self):
+        """Adjacency entries, i.e. twice the number of undirected edges."""
+        lib, h = self._load("bd")
+        return lib.bd_arcs(h)
+
+    @property
+    def weighted(self):
+        lib, h = self._load("bd")
+        return bool(lib.bd_weighted(h))
+
+    def bounding_diameters(self, strategy=1, sumsweep=0, batch=1, threads=0, propagate=False):
+        """BoundingDiameters as `./bounding --strategy S` with --sumsweep/--batch/--threads/--propagate.
+        strategy=4 is the 3/2-approximation (default --samples and --seed)."""
+        lib, h = self._load("bd")
+        r = _check(lib.bd_run(h, strategy, sumsweep, batch, threads, int(propagate)), lib, "bd")
+        return BDResult(lib, r, lib.bd_vertices(h))
+
+    def ifub(self, strategy=1, seed=0, sweeps=0):
+        """iFUB as `cresc strategy graph --seed S --sweeps k`."""
+        lib, h = self._load("ifub")
+        out = (ctypes.c_double * 4)()
+        if lib.ifub_run(h, strategy, seed, sweeps, out) != 0:
+            raise RuntimeError(lib.ifub_error().decode())
+        return {"diameter": out[0], "root": int(out[1]),
+                "bfs_calls": int(out[2]), "seconds": out[3]}
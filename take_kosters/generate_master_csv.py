@@ -10,16 +10,22 @@ and writes out:
 
 Usage:
     python generate_master_csv.py --binary ./bounding --graph mygraph.mtx
+
+Without --binary the strategies run in-process through diameter.py
+(libbounding.so): the graph is loaded once and nothing is parsed from text.
 """
 import subprocess
 import pandas as pd
 import io
 import argparse
 import sys
+from iterlog import read_iterlog
 
-def run_strategy(binary, strategy, graph):
+def run_strategy(binary, strategy, graph, log_bin=None):
     """Run `binary --strategy {strategy} {graph}` and return its stdout."""
     cmd = [binary, "--strategy", str(strategy), graph]
+    if log_bin:
+        cmd += ["--log-bin", log_bin]
     out = subprocess.check_output(cmd, text=True)
     return out
 
@@ -65,10 +71,31 @@ def parse_iters(block2, strategy):
         df["Strategy"] = strategy
     return df
 
+def run_inprocess(graph_path, strategies):
+    """Run the strategies on one resident graph; returns (summaries, iters)."""
+    import resource
+    import diameter
+    g = diameter.Graph(graph_path)
+    summaries, iters = [], []
+    for strat in strategies:
+        sys.stdout.write(f"Running strategy {strat}...\n")
+        r = g.bounding_diameters(strategy=strat)
+        summaries.append(pd.DataFrame([{
+            "Dataset": graph_path, "|V|": g.n, "|E|": g.arcs,
+            "AvgDeg": g.arcs / g.n, "Strategy": strat,
+            "EccCalls": r.ecc_calls, "PrunedNodes": r.pruned,
+            "TotalTime(s)": r.time,
+            "Memory(KB)": resource.getrusage(resource.RUSAGE_SELF).ru_maxrss}]))
+        df = pd.DataFrame(r.log[:, :4].astype(int), columns=diameter.LOG_COLUMNS[:4])
+        df["Strategy"] = strat
+        iters.append(df)
+    return summaries, iters
+
 def main():
     p = argparse.ArgumentParser()
-    p.add_argument("--binary", required=True,
-                   help="Path to your compiled C++ binary (e.g. ./bounding)")
+    p.add_argument("--binary",
+                   help="Path to your compiled C++ binary (e.g. ./bounding); "
+                        "omit to run in-process via diameter.py")
     p.add_argument("--graph", required=True,
                    help="Path to the .mtx graph file")
     args = p.parse_args()
@@ -76,13 +103,18 @@ def main():
     all_summaries = []
     all_iters     = []
 
-    for strat in [1,2,3]:
+    if args.binary is None:
+        all_summaries, all_iters = run_inprocess(args.graph, [1,2,3])
+
+    for strat in ([1,2,3] if args.binary else []):
         sys.stdout.write(f"Running strategy {strat}...\n")
-        out = run_strategy(args.binary, strat, args.graph)
+        # the iteration log comes from the binary log, not from stdout
+        log_bin = f"iters_s{strat}.bdlog"
+        out = run_strategy(args.binary, strat, args.graph, log_bin)
 
         block1, block2 = split_blocks(out)
         df_sum = parse_summary(block1)
-        df_it  = parse_iters(block2, strat)
+        df_it  = read_iterlog(log_bin)[["iter", "|W|", "DeltaL", "DeltaU", "Strategy"]]
 
         all_summaries.append(df_sum)
         all_iters.append(df_it)
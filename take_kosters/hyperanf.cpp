@@ -0,0 +1,264 @@
+// hyperanf.cpp
+// Approximate neighbourhood function with HyperANF (Boldi, Rosa, Vigna) for
+// graphs too large for an exact diameter. Every vertex keeps a HyperLogLog
+// counter of the vertices within distance t; iteration t+1 replaces it by the
+// union with its neighbours' counters. Summing the counter estimates gives
+// N(t), the number of pairs within distance t, from which the distance
+// distribution and the effective diameter follow.
+//
+// A register of v can only grow at iteration t because of a vertex at
+// distance exactly t from v, so the last iteration in which any counter
+// changed is an exact lower bound on the diameter, and the last change of
+// v's own counter is a lower bound on ecc(v). Vertices whose counters settle
+// first are central, those changing last are peripheral; both are written as
+// candidate roots for Crescenzi.cpp and takes_kosters.cpp (--candidates).
+#include <bits/stdc++.h>
+#include <sys/resource.h>
+using namespace std;
+using Clock = chrono::high_resolution_clock;
+
+#include "../common/graph_io.hpp"
+
+// ——— Undirected graph in CSR form ———
+struct Graph {
+    int n = 0;
+    vector<int64_t> start; // neighbours of u: adj[start[u] .. start[u+1])
+    vector<int>     adj;
+
+    Graph() {}
+    Graph(int _n, const vector<pair<int,int>>& edges): n(_n) {
+        start.assign(n + 1, 0);
+        for(auto [u,v] : edges){ start[u + 1]++; start[v + 1]++; }
+        for(int i = 0; i < n; ++i) start[i + 1] += start[i];
+        adj.resize(start[n]);
+        vector<int64_t> pos(start.begin(), start.end() - 1);
+        for(auto [u,v] : edges){
+            adj[pos[u]++] = v;
+            adj[pos[v]++] = u;
+        }
+    }
+};
+
+// Any format of common/graph_io.hpp: .mtx, .gbin (Generator/graph_gen), SNAP
+// edge lists and METIS graphs, optionally .gz/.zst-compressed. Weights are
+// ignored, since the neighbourhood function counts hops, and self-loops are
+// dropped.
+Graph load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    vector<pair<int,int>> edges;
+    edges.reserve(E.edges.size());
+    for(auto& [u,v,w] : E.edges) if(u != v) edges.emplace_back(u, v);
+    E.edges = {};
+    return Graph(E.n, edges);
+}
+
+// ——— HyperLogLog counters ———
+// m = 2^b one-byte registers per vertex, stored contiguously so a union is a
+// byte-wise max over m bytes, which the compiler turns into vector max
+// instructions. Relative standard error of one counter is about 1.04/sqrt(m).
+struct Counters {
+    int b, m;
+    vector<uint8_t> reg; // n * m
+
+    Counters(int n, int _b): b(_b), m(1 << _b), reg(size_t(n) << _b, 0) {}
+    uint8_t*       at(int v)       { return reg.data() + (size_t(v) << b); }
+    const uint8_t* at(int v) const { return reg.data() + (size_t(v) << b); }
+};
+
+static inline uint64_t mix64(uint64_t x){
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Adds v itself to its counter: the top b bits of the hash pick the register,
+// the position of the first set bit in the rest is the observed rank.
+void init_counter(Counters& C, int v, uint64_t seed){
+    uint64_t h = mix64(uint64_t(v) ^ mix64(seed));
+    int idx = h >> (64 - C.b);
+    uint64_t rest = (h << C.b) | (1ULL << (C.b - 1));
+    C.at(v)[idx] = __builtin_clzll(rest) + 1;
+}
+
+// dst = max(dst, src); returns whether any register of dst grew.
+static inline bool union_into(uint8_t* __restrict dst, const uint8_t* __restrict src, int m){
+    uint8_t grew = 0;
+    for(int j = 0; j < m; ++j){
+        grew |= src[j] > dst[j];
+        dst[j] = max(dst[j], src[j]);
+    }
+    return grew;
+}
+
+double estimate(const uint8_t* r, int m){
+    double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+    double sum = 0;
+    int zeros = 0;
+    for(int j = 0; j < m; ++j){
+        sum += ldexp(1.0, -r[j]);
+        zeros += r[j] == 0;
+    }
+    double E = alpha * m * m / sum;
+    if(E <= 2.5 * m && zeros > 0) E = m * log(double(m) / zeros); // linear counting
+    return E;
+}
+
+// ——— HyperANF iterations ———
+struct AnfResult {
+    vector<double> N;        // N[t]: estimated pairs within distance t
+    vector<int> lastChange;  // last iteration in which v's counter grew
+    vector<float> reach;     // final counter estimate (size of v's component)
+    int iterations = 0;      // last iteration with any change (diameter lower bound)
+};
+
+// Only vertices with a neighbour whose counter grew in the previous
+// iteration can change, so the rest just copy their counter forward.
+AnfResult hyper_anf(const Graph& G, int b, uint64_t seed, int threads, int maxIter){
+    const int n = G.n;
+    Counters cur(n, b), next(n, b);
+    const int m = cur.m;
+    for(int v = 0; v < n; ++v) init_counter(cur, v, seed);
+    vector<char> modified(n, 1), nextModified(n, 0);
+    AnfResult R;
+    R.lastChange.assign(n, 0);
+
+    auto total = [&](const Counters& C){
+        vector<double> part(threads, 0.0);
+        vector<thread> pool;
+        for(int t = 0; t < threads; ++t) pool.emplace_back([&, t]{
+            for(int v = int(int64_t(n) * t / threads); v < int(int64_t(n) * (t + 1) / threads); ++v)
+                part[t] += estimate(C.at(v), m);
+        });
+        for(auto& th : pool) th.join();
+        return accumulate(part.begin(), part.end(), 0.0);
+    };
+    R.N.push_back(total(cur));
+
+    const int CHUNK = 1024;
+    for(int t = 1; t <= maxIter; ++t){
+        atomic<int> cursor{0};
+        atomic<bool> anyChange{false};
+        vector<thread> pool;
+        for(int th = 0; th < threads; ++th) pool.emplace_back([&]{
+            bool changed = false;
+            for(int c; (c = cursor.fetch_add(CHUNK, memory_order_relaxed)) < n; ){
+                for(int v = c; v < min(n, c + CHUNK); ++v){
+                    uint8_t* dst = next.at(v);
+                    memcpy(dst, cur.at(v), m);
+                    bool grew = false;
+                    for(int64_t i = G.start[v]; i < G.start[v + 1]; ++i){
+                        int u = G.adj[i];
+                        if(modified[u]) grew |= union_into(dst, cur.at(u), m);
+                    }
+                    nextModified[v] = grew;
+                    if(grew){ R.lastChange[v] = t; changed = true; }
+                }
+            }
+            if(changed) anyChange.store(true, memory_order_relaxed);
+        });
+        for(auto& th : pool) th.join();
+        if(!anyChange) break;
+        swap(cur.reg, next.reg);
+        swap(modified, nextModified);
+        R.iterations = t;
+        R.N.push_back(total(cur));
+    }
+    R.reach.resize(n);
+    for(int v = 0; v < n; ++v) R.reach[v] = estimate(cur.at(v), m);
+    return R;
+}
+
+// Interpolated smallest t with N(t) >= q * N(max), as in the ANF paper.
+double effective_diameter(const vector<double>& N, double q){
+    double target = q * N.back();
+    for(size_t t = 0; t < N.size(); ++t){
+        if(N[t] >= target){
+            if(t == 0) return 0;
+            return (t - 1) + (target - N[t - 1]) / (N[t] - N[t - 1]);
+        }
+    }
+    return N.size() - 1;
+}
+
+// ——— main() ———
+int main(int argc, char* argv[]){
+    if(argc < 2){
+        cerr << "Usage: " << argv[0] << " graph.mtx [--log2m b] [--mem MB] [--threads T]"
+                " [--seed S] [--max-iter k] [--quantile q] [--candidates out.csv] [--top k]\n";
+        return 1;
+    }
+    int b = 6, threads = max(1u, thread::hardware_concurrency()), maxIter = INT_MAX, top = 8;
+    double memMB = 0, quantile = 0.9;
+    uint64_t seed = 0;
+    string candPath;
+    for(int i = 2; i + 1 < argc; i += 2){
+        string flag = argv[i];
+        if(flag == "--log2m") b = stoi(argv[i+1]);
+        else if(flag == "--mem") memMB = stod(argv[i+1]);
+        else if(flag == "--threads") threads = max(1, stoi(argv[i+1]));
+        else if(flag == "--seed") seed = stoull(argv[i+1]);
+        else if(flag == "--max-iter") maxIter = max(1, stoi(argv[i+1]));
+        else if(flag == "--quantile") quantile = stod(argv[i+1]);
+        else if(flag == "--candidates") candPath = argv[i+1];
+        else if(flag == "--top") top = max(1, stoi(argv[i+1]));
+        else { cerr << "Unknown option " << flag << "\n"; return 1; }
+    }
+    if(b < 4 || b > 16){ cerr << "--log2m must be in [4,16]\n"; return 1; }
+
+    Graph G = load_graph(argv[1]);
+    // two counter arrays of n * 2^b bytes must fit in the budget
+    if(memMB > 0){
+        while(b > 4 && 2.0 * G.n * (1 << b) > memMB * (1 << 20)) --b;
+        if(2.0 * G.n * (1 << b) > memMB * (1 << 20))
+            cerr << "Warning: counters need " << 2.0 * G.n * 16 / (1 << 20)
+                 << " MB even at 16 registers\n";
+    }
+
+    auto t0 = Clock::now();
+    AnfResult R = hyper_anf(G, b, seed, threads, maxIter);
+    double seconds = chrono::duration<double>(Clock::now() - t0).count();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long peak_rss = usage.ru_maxrss;
+
+    cout << "Vertices:" << G.n << "\n"
+         << "Registers:" << (1 << b) << "\n"
+         << "Iterations:" << R.iterations << "\n"
+         << "Diameter_Lower_Bound:" << R.iterations << "\n"
+         << "Effective_Diameter:" << effective_diameter(R.N, quantile) << "\n"
+         << "Reachable_Pairs:" << R.N.back() << "\n"
+         << "Time(s):" << seconds << "\n"
+         << "Peak_RSS:    " << peak_rss
+                  << (sizeof(peak_rss)==sizeof(long)? " KB":" bytes")
+         << "\n";
+    cout << "# distance,pairs_within,pairs_at\n";
+    for(size_t t = 0; t < R.N.size(); ++t)
+        cout << t << "," << R.N[t] << "," << (t ? R.N[t] - R.N[t-1] : R.N[0]) << "\n";
+
+    // Only vertices that reach at least half as many vertices as the best one
+    // are candidates, which keeps isolated vertices and small components
+    // (they settle early too) out. Centre: earliest-settling counters, ties
+    // broken by higher degree. Periphery: counters changing last.
+    if(!candPath.empty()){
+        float maxReach = *max_element(R.reach.begin(), R.reach.end());
+        vector<int> order;
+        for(int v = 0; v < G.n; ++v) if(R.reach[v] >= 0.5f * maxReach) order.push_back(v);
+        top = min<int>(top, order.size());
+        partial_sort(order.begin(), order.begin() + top, order.end(), [&](int a, int c){
+            if(R.lastChange[a] != R.lastChange[c]) return R.lastChange[a] < R.lastChange[c];
+            return G.start[a + 1] - G.start[a] > G.start[c + 1] - G.start[c];
+        });
+        vector<int> centre(order.begin(), order.begin() + top);
+        partial_sort(order.begin(), order.begin() + top, order.end(), [&](int a, int c){
+            return R.lastChange[a] > R.lastChange[c];
+        });
+        ofstream out(candPath);
+        if(!out) throw runtime_error("Cannot write "+candPath);
+        out << "# vertex,role,last_change\n";
+        for(int v : centre) out << v << ",center," << R.lastChange[v] << "\n";
+        for(int i = 0; i < top; ++i) out << order[i] << ",periphery," << R.lastChange[order[i]] << "\n";
+    }
+    return 0;
+}
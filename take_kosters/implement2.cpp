@@ -7,6 +7,9 @@
 using namespace std;
 using Clock = chrono::high_resolution_clock;
 
+#include "../common/graph_io.hpp"
+#include "../common/delta_stepping.hpp"
+
 // --- Graph definition and loader ---
 struct Graph {
     int n;
@@ -22,32 +25,12 @@ struct Graph {
     }
 };
 
-Graph load_mm_graph(const string& path) {
-    ifstream in(path);
-    if (!in) throw runtime_error("Cannot open " + path);
-    string header;
-    getline(in, header);
-    if (header.rfind("%%MatrixMarket", 0) != 0)
-        throw runtime_error("Not a MatrixMarket file");
-    bool is_pattern = header.find("pattern") != string::npos;
-    bool is_weighted_file = !is_pattern &&
-                           (header.find("real") != string::npos ||
-                            header.find("integer") != string::npos);
-    // skip comments
-    string line;
-    while (getline(in, line) && line.size() && line[0] == '%');
-    istringstream iss(line);
-    int M, N_nodes, L_links; 
-    iss >> M >> N_nodes >> L_links;
-    if (M != N_nodes) throw runtime_error("Only square graphs supported (M==N)");
-    Graph G(N_nodes); 
-    for (int i = 0; i < L_links; i++) {
-        int u, v;
-        double w = 1.0;
-        in >> u >> v;
-        if (is_weighted_file) in >> w;
-        G.add_edge(u - 1, v - 1, w); 
-    }
+// Any format of common/graph_io.hpp: .mtx, .gbin (Generator/graph_gen), SNAP
+// edge lists and METIS graphs, optionally .gz/.zst-compressed.
+Graph load_graph(const string& path){
+    EdgeList E = load_edges(path);
+    Graph G(E.n);
+    for(auto& [u,v,w] : E.edges) G.add_edge(u, v, w);
     return G;
 }
 
@@ -98,18 +81,22 @@ int computeEccentricity(const Graph& G, int src, vector<int>& dist_vector) {
             return 0;
         }
 
-        while (!pq.empty()) {
-            auto [du, u] = pq.top();
-            pq.pop();
-
-            if (du > d_double[u] + 1e-9) continue; 
-
-            for (const auto& edge_pair : G.adj[u]) {
-                int v = edge_pair.first;
-                double w = edge_pair.second;
-                if (d_double[u] != numeric_limits<double>::infinity() && d_double[u] + w < d_double[v] - 1e-9) {
-                    d_double[v] = d_double[u] + w;
-                    pq.emplace(d_double[v], v);
+        if (DELTA.enabled) {
+            delta_stepping(G, src, d_double);
+        } else {
+            while (!pq.empty()) {
+                auto [du, u] = pq.top();
+                pq.pop();
+
+                if (du > d_double[u] + 1e-9) continue; 
+
+                for (const auto& edge_pair : G.adj[u]) {
+                    int v = edge_pair.first;
+                    double w = edge_pair.second;
+                    if (d_double[u] != numeric_limits<double>::infinity() && d_double[u] + w < d_double[v] - 1e-9) {
+                        d_double[v] = d_double[u] + w;
+                        pq.emplace(d_double[v], v);
+                    }
                 }
             }
         }
@@ -134,13 +121,23 @@ int computeEccentricity(const Graph& G, int src, vector<int>& dist_vector) {
 // --- Selection strategies (§4.4) ---
 enum Strategy { BOUND_DIFF = 1, INTERCHANGE = 2, REPEATED = 3 };
 
+// Per-run selection state instead of function statics, so runs are
+// repeatable and can execute concurrently.
+struct SelectorState {
+    Strategy strat;
+    int prevSelectedNode = -1;
+    bool pick_high_epsU = true;
+    SelectorState(Strategy s) : strat(s) {}
+};
+
 int selectFrom(const vector<bool>& inW,
-               const vector<long long>& epsL, 
-               const vector<long long>& epsU, 
+               const vector<int>& epsL, 
+               const vector<int>& epsU, 
                const vector<int>& lastDist, 
                const Graph& G,
-               Strategy strat,
-               int prevSelectedNode) { 
+               SelectorState& state) { 
+    Strategy strat = state.strat;
+    int prevSelectedNode = state.prevSelectedNode;
     int best_node = -1;
     
     if (strat == Strategy::BOUND_DIFF) {
@@ -149,10 +146,10 @@ int selectFrom(const vector<bool>& inW,
             if (inW[w]) {
                 long long current_diff;
                 // Prioritize nodes whose bounds haven't been updated much from INF
-                if (epsU[w] == LLONG_MAX && epsL[w] == LLONG_MIN) current_diff = LLONG_MAX;
-                else if (epsU[w] == LLONG_MAX) current_diff = LLONG_MAX -1; // Slightly less than fully uninitialized
-                else if (epsL[w] == LLONG_MIN) current_diff = LLONG_MAX -2;
-                else current_diff = epsU[w] - epsL[w];
+                if (epsU[w] == INT_MAX && epsL[w] == INT_MIN) current_diff = LLONG_MAX;
+                else if (epsU[w] == INT_MAX) current_diff = LLONG_MAX -1; // Slightly less than fully uninitialized
+                else if (epsL[w] == INT_MIN) current_diff = LLONG_MAX -2;
+                else current_diff = (long long)epsU[w] - epsL[w];
 
 
                 if (current_diff > max_diff) {
@@ -166,8 +163,7 @@ int selectFrom(const vector<bool>& inW,
             }
         }
     } else if (strat == Strategy::INTERCHANGE) {
-        static bool pick_high_epsU = true; 
-        if (pick_high_epsU) { 
+        if (state.pick_high_epsU) { 
             long long current_max_epsU = LLONG_MIN;
             for (int w = 0; w < G.n; w++) {
                 if (inW[w]) {
@@ -196,7 +192,7 @@ int selectFrom(const vector<bool>& inW,
                 }
             }
         }
-        pick_high_epsU = !pick_high_epsU;
+        state.pick_high_epsU = !state.pick_high_epsU;
     } else if (strat == Strategy::REPEATED) {
         if (prevSelectedNode < 0) { 
             int max_degree = -1;
@@ -252,10 +248,12 @@ RunStats boundingDiametersInstr(const Graph& G, Strategy strat) {
     if (n == 0) return S; 
 
     long long current_Wsize = n; 
-    int prev_selected_node = -1;
+    SelectorState selector(strat);
     vector<bool> inW(n, true);
-    vector<long long> epsL(n, LLONG_MIN); 
-    vector<long long> epsU(n, LLONG_MAX); 
+    // Bounds are distances, so int (INT_MIN/INT_MAX = unset) is wide enough
+    // and halves the per-vertex bound state of a long long pair.
+    vector<int> epsL(n, INT_MIN); 
+    vector<int> epsU(n, INT_MAX); 
     vector<int> distances_from_v(n); 
 
     long long deltaL = 0; 
@@ -264,13 +262,13 @@ RunStats boundingDiametersInstr(const Graph& G, Strategy strat) {
     int iter = 0;
 
     while (deltaL < deltaU && current_Wsize > 0) {
-        int v_selected = selectFrom(inW, epsL, epsU, distances_from_v, G, strat, prev_selected_node);
+        int v_selected = selectFrom(inW, epsL, epsU, distances_from_v, G, selector);
         
         if (v_selected == -1) { // No selectable node found in W (W might be empty or all nodes filtered unexpectedly)
             break; 
         }
 
-        prev_selected_node = v_selected;
+        selector.prevSelectedNode = v_selected;
 
         auto t0 = Clock::now();
         int ecc_v = computeEccentricity(G, v_selected, distances_from_v);
@@ -296,8 +294,8 @@ RunStats boundingDiametersInstr(const Graph& G, Strategy strat) {
 
                 if (d_v_w != INT_MAX) { 
                     long long ecc_v_ll = ecc_v;
-                    epsL[w] = max(epsL[w], max(ecc_v_ll - d_v_w, d_v_w));
-                    epsU[w] = min(epsU[w], ecc_v_ll + d_v_w);
+                    epsL[w] = max<long long>(epsL[w], max(ecc_v_ll - d_v_w, d_v_w));
+                    epsU[w] = min<long long>(epsU[w], ecc_v_ll + d_v_w);
                 }
                 
                 bool condition1 = (epsU[w] <= deltaL && epsL[w] >= deltaU / 2); 
@@ -332,12 +330,23 @@ int main(int argc, char* argv[]) {
 
     if (argc < 4) {
         cerr << "Usage: " << argv[0]
-             << " --strategy [1|2|3] graph.mtx\n";
+             << " --strategy [1|2|3] graph.mtx [--sssp dijkstra|delta] [--delta D] [--threads T]\n";
         return 1;
     }
+    for (int i = 4; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        if (flag == "--sssp") DELTA.enabled = string(argv[i + 1]) == "delta";
+        else if (flag == "--delta") {
+            DELTA.delta = stod(argv[i + 1]);
+            if (!(DELTA.delta > 0)) { cerr << "--delta must be positive\n"; return 1; }
+        }
+        else if (flag == "--threads") DELTA.threads = max(1, stoi(argv[i + 1]));
+        else { cerr << "Unknown option " << flag << "\n"; return 1; }
+    }
     Strategy strat = Strategy(stoi(argv[2]));
     string graph_path = argv[3];
-    Graph G = load_mm_graph(graph_path);
+    Graph G = load_graph(graph_path);
+    if (DELTA.enabled && DELTA.delta <= 0) DELTA.delta = auto_delta(G);
 
     long long sum_degrees = 0;
     for (int i = 0; i < G.n; ++i) {
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+"""
+iterlog.py
+
+Reader for the binary iteration logs written by `./bounding --log-bin file`.
+A 24-byte header ("BDLG", version, columns, every, strategy, 0) is followed by
+little-endian int32 records iter,|W|,DeltaL,DeltaU,Batch,Propagated (version 1
+logs stop at Batch). The records are
+memory-mapped, so large logs are not read into memory up front.
+
+Usage:
+    from iterlog import read_iterlog
+    df = read_iterlog("s1.bdlog")   # columns iter,|W|,DeltaL,DeltaU,Batch,Propagated,Strategy
+"""
+import numpy as np
+import pandas as pd
+
+COLUMNS = ["iter", "|W|", "DeltaL", "DeltaU", "Batch", "Propagated"]
+HEADER_BYTES = 24
+
+def read_header(path):
+    """Return (version, columns, every, strategy) of a .bdlog file."""
+    with open(path, "rb") as f:
+        raw = f.read(HEADER_BYTES)
+    if len(raw) < HEADER_BYTES or raw[:4] != b"BDLG":
+        raise ValueError(f"{path} is not a BoundingDiameters iteration log")
+    version, columns, every, strategy, _ = np.frombuffer(raw[4:], dtype="<u4")
+    if version not in (1, 2):
+        raise ValueError(f"{path}: unsupported log version {version}")
+    return int(version), int(columns), int(every), int(strategy)
+
+def read_records(path):
+    """The records as an (iterations x columns) int32 array backed by the file."""
+    _, columns, _, _ = read_header(path)
+    data = np.memmap(path, dtype="<i4", mode="r", offset=HEADER_BYTES)
+    return data[: len(data) - len(data) % columns].reshape(-1, columns)
+
+def read_iterlog(path):
+    """The log as a DataFrame with the columns of master_iters.csv plus Batch
+    (and Propagated from version 2)."""
+    _, columns, _, strategy = read_header(path)
+    df = pd.DataFrame(np.asarray(read_records(path)), columns=COLUMNS[:columns])
+    df["Strategy"] = strategy
+    return df
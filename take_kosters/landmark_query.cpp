@@ -0,0 +1,111 @@
+// landmark_query.cpp
+// Distance and eccentricity bounds from the landmark file written by
+// `bounding --landmarks` or `cresc --landmarks`: the BFS distance arrays of
+// a diameter run, kept instead of discarded. For landmarks l,
+//   d(u,v)  in [max_l |d(l,u) - d(l,v)|, min_l d(l,u) + d(l,v)]
+//   ecc(v)  in [max_l max(d(l,v), ecc(l) - d(l,v)), min_l ecc(l) + d(l,v)]
+// and a landmark reaching exactly one of u, v proves them disconnected.
+// The arrays are transposed to vertex-major rows at load, so a query reads
+// one contiguous row per vertex.
+#include <bits/stdc++.h>
+#include "../common/landmarks.hpp"
+using namespace std;
+using Clock = chrono::high_resolution_clock;
+
+const int64_t INF = INT64_MAX;
+
+struct LandmarkOracle {
+    int n = 0, count = 0;
+    vector<int> src, ecc;
+    vector<int> rows; // n x count, INT_MAX: unreached from that landmark
+
+    explicit LandmarkOracle(const string& path){
+        LandmarkSet L;
+        L.path = path;
+        n = L.read();
+        count = L.kept.size();
+        rows.resize((size_t)n * count);
+        for(int l = 0; l < count; ++l){
+            Landmark& lm = L.kept[l];
+            src.push_back(lm.src);
+            ecc.push_back(lm.ecc);
+            for(int v = 0; v < n; ++v) rows[(size_t)v * count + l] = lm.at(v);
+            lm.data = {};
+        }
+    }
+
+    const int* row(int v) const { return &rows[(size_t)v * count]; }
+
+    // {lower, upper}; {INF, INF} when a landmark separates u and v, upper INF
+    // when no landmark reaches either.
+    pair<int64_t,int64_t> distance(int u, int v) const {
+        if(u == v) return {0, 0};
+        const int *a = row(u), *b = row(v);
+        int64_t lo = 1, hi = INF;
+        for(int l = 0; l < count; ++l){
+            if(a[l] == INT_MAX && b[l] == INT_MAX) continue;
+            if(a[l] == INT_MAX || b[l] == INT_MAX) return {INF, INF};
+            lo = max<int64_t>(lo, abs(a[l] - b[l]));
+            hi = min<int64_t>(hi, (int64_t)a[l] + b[l]);
+        }
+        return {lo, hi};
+    }
+
+    // Eccentricity within v's component.
+    pair<int64_t,int64_t> eccentricity(int v) const {
+        const int* a = row(v);
+        int64_t lo = 0, hi = INF;
+        for(int l = 0; l < count; ++l){
+            if(a[l] == INT_MAX) continue;
+            lo = max<int64_t>(lo, max(a[l], ecc[l] - a[l]));
+            hi = min<int64_t>(hi, (int64_t)ecc[l] + a[l]);
+        }
+        return {lo, hi};
+    }
+};
+
+string show(int64_t x){ return x == INF ? "inf" : to_string(x); }
+
+int main(int argc, char* argv[]){
+    if(argc < 2){
+        cerr << "Usage: " << argv[0] << " landmarks.lmk [queries.txt]\n"
+             << "  query lines: \"u v\" (distance) or \"v\" (eccentricity), 0-based\n";
+        return 1;
+    }
+    LandmarkOracle O(argv[1]);
+    ifstream file;
+    if(argc > 2){
+        file.open(argv[2]);
+        if(!file){ cerr << "Cannot open " << argv[2] << "\n"; return 1; }
+    }
+    istream& in = argc > 2 ? file : cin;
+    cerr << "# " << O.count << " landmarks over " << O.n << " vertices\n";
+
+    cout << "# query,u,v,lower,upper\n";
+    string line, out;
+    long long queries = 0;
+    double seconds = 0;
+    while(getline(in, line)){
+        if(line.empty() || line[0] == '#') continue;
+        istringstream iss(line);
+        long long u, v;
+        if(!(iss >> u)) continue;
+        bool isPair = bool(iss >> v);
+        if(u < 0 || u >= O.n || (isPair && (v < 0 || v >= O.n))){
+            cerr << "Vertex out of range: " << line << "\n";
+            return 1;
+        }
+        auto t0 = Clock::now();
+        auto [lo, hi] = isPair ? O.distance(u, v) : O.eccentricity(u);
+        seconds += chrono::duration<double>(Clock::now() - t0).count();
+        ++queries;
+        out += isPair ? "dist," + to_string(u) + "," + to_string(v)
+                    : "ecc," + to_string(u) + ",";
+        out += "," + show(lo) + "," + show(hi) + "\n";
+    }
+    cout << out;
+    if(queries)
+        cerr << "# " << queries << " queries in " << seconds << " s ("
+             << seconds / queries * 1e9 << " ns each)\n";
+    return 0;
+}
@@ -4,7 +4,9 @@ plot_master_results.py
 
 Reads in:
   - master_summary.csv (columns: Dataset,|V|,|E|,AvgDeg,Strategy,EccCalls,PrunedNodes,TotalTime(s))
-  - master_iters.csv   (columns: iter,|W|,DeltaL,DeltaU,Strategy)
+  - master_iters.csv   (columns: iter,|W|,DeltaL,DeltaU,Strategy), or binary
+    iteration logs (`./bounding --log-bin`, read with iterlog.py) given with
+    --iter-logs or found as *.bdlog in the input directory
 
 Generates these PNG plots:
   1. EccCalls.png        - Number of eccentricity calls by strategy
@@ -95,12 +97,22 @@ def main():
     import argparse
     parser = argparse.ArgumentParser()
     parser.add_argument('--input-dir', default='.', help='Directory containing the CSV files')
+    parser.add_argument('--iter-logs', nargs='*', default=None,
+                        help='Binary iteration logs to plot instead of master_iters.csv')
     args = parser.parse_args()
 
     # Load the master CSVs from the specified directory
     import os
+    import glob
+    from iterlog import read_iterlog
     df_sum = pd.read_csv(os.path.join(args.input_dir, 'master_summary.csv'))
-    df_it  = pd.read_csv(os.path.join(args.input_dir, 'master_iters.csv'))
+    logs = args.iter_logs
+    if logs is None and not os.path.exists(os.path.join(args.input_dir, 'master_iters.csv')):
+        logs = sorted(glob.glob(os.path.join(args.input_dir, '*.bdlog')))
+    if logs:
+        df_it = pd.concat([read_iterlog(f) for f in logs], ignore_index=True)
+    else:
+        df_it = pd.read_csv(os.path.join(args.input_dir, 'master_iters.csv'))
 
     # Change to input directory for saving plots
     os.chdir(args.input_dir)
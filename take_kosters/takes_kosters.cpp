@@ -1,58 +1,86 @@
 // main.cpp
 #include <bits/stdc++.h>
 #include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
 using namespace std;
 using Clock = chrono::high_resolution_clock;
 
-// ——— Graph definition and loader ———
-using Edge = tuple<int,int,double>;
-struct Graph {
-    int n;
-    vector<vector<Edge>> adj;
-    bool weighted = false;
-    Graph(int _n): n(_n), adj(n) {}
-    void add_edge(int u,int v,double w=1.0){
-        adj[u].emplace_back(u,v,w);
-        adj[v].emplace_back(v,u,w);
-        if(w!=1.0) weighted = true;
+// ——— Allocation tracking ———
+// Memory(KB) is ru_maxrss and cannot say which structure the bytes belong to.
+// The main containers use a counting allocator tagged by structure; the
+// per-structure live/peak bytes are reported on stderr next to the CSV, once
+// for loading and once for the run, with peaks reset in between.
+enum MemCat { MEM_GRAPH, MEM_DIST, MEM_EPS, MEM_W, MEM_LOG, MEM_CATS };
+const char* MEM_NAMES[MEM_CATS] = {"graph","dist","epsL/epsU","W","log"};
+struct MemCounter { size_t live=0, peak=0; };
+MemCounter MEM[MEM_CATS], MEM_TOTAL;
+MemCounter MEM_LOAD[MEM_CATS], MEM_LOAD_TOTAL; // snapshot at the end of loading
+mutex MEM_MU; // --batch runs several BFS/Dijkstra calls at once
+
+void mem_add(int c,ptrdiff_t b){
+    lock_guard<mutex> lk(MEM_MU);
+    MEM[c].live+=b; MEM[c].peak=max(MEM[c].peak,MEM[c].live);
+    MEM_TOTAL.live+=b; MEM_TOTAL.peak=max(MEM_TOTAL.peak,MEM_TOTAL.live);
+}
+void mem_reset_peaks(){
+    for(auto& m:MEM) m.peak=m.live;
+    MEM_TOTAL.peak=MEM_TOTAL.live;
+}
+void mem_print(ostream& os,const char* phase,const MemCounter* m,const MemCounter& total){
+    for(int c=0;c<MEM_CATS;c++)
+        os<<phase<<","<<MEM_NAMES[c]<<","<<m[c].live<<","<<m[c].peak<<"\n";
+    os<<phase<<",total,"<<total.live<<","<<total.peak<<"\n";
+}
+
+template<class T,int Cat> struct TrackedAlloc {
+    using value_type=T;
+    template<class U> struct rebind { using other=TrackedAlloc<U,Cat>; };
+    TrackedAlloc()=default;
+    template<class U> TrackedAlloc(const TrackedAlloc<U,Cat>&){}
+    T* allocate(size_t n){
+        mem_add(Cat,n*sizeof(T));
+        return static_cast<T*>(::operator new(n*sizeof(T)));
+    }
+    void deallocate(T* p,size_t n){
+        mem_add(Cat,-(ptrdiff_t)(n*sizeof(T)));
+        ::operator delete(p);
     }
+    template<class U> bool operator==(const TrackedAlloc<U,Cat>&) const { return true; }
+    template<class U> bool operator!=(const TrackedAlloc<U,Cat>&) const { return false; }
 };
+template<class T,int Cat> using tvector = vector<T,TrackedAlloc<T,Cat>>;
 
-Graph load_mm_graph(const string& path){
-    ifstream in(path);
-    if(!in) throw runtime_error("Cannot open "+path);
-    string header; getline(in, header);
-    if(header.rfind("%%MatrixMarket",0)!=0)
-        throw runtime_error("Not a MatrixMarket file");
-    bool is_pattern  = header.find("pattern")!=string::npos;
-    bool is_weighted = !is_pattern
-                    && (header.find("real")   != string::npos
-                     || header.find("integer")!= string::npos);
-    // skip comments
-    string line;
-    while(getline(in,line) && line.size() && line[0]=='%');
-    istringstream iss(line);
-    int M,N,L; iss>>M>>N>>L;
-    if(M!=N) throw runtime_error("Only square graphs supported");
-    Graph G(M);
-    for(int i=0;i<L;i++){
-        int u,v; double w=1.0;
-        in>>u>>v;
-        if(is_weighted) in>>w;
-        G.add_edge(u-1,v-1,w);
-    }
-    return G;
-}
+using DistVec = tvector<int,MEM_DIST>;
+
+// Shared graph code; its graph and landmark arrays count as graph and dist.
+template<class T> using GraphAlloc = TrackedAlloc<T,MEM_GRAPH>;
+template<class T> using DistAlloc  = TrackedAlloc<T,MEM_DIST>;
+#define GRAPH_ALLOC    GraphAlloc
+#define LANDMARK_ALLOC DistAlloc
+#include "../common/graph_io.hpp"
+#include "../common/trace.hpp"
+#include "../common/parallel_bfs.hpp"
+#include "../common/landmarks.hpp"
+#include "../common/delta_stepping.hpp"
 
 // ——— Single‐source distances & eccentricity ———
-int computeEccentricity(const Graph& G, int src, vector<int>& dist){
+template<class Graph>
+int computeEccentricity(const Graph& G, int src, DistVec& dist){
+    double ts = TRACE.enabled ? TRACE.now() : 0;
+    if(!G.weighted && use_parallel_bfs(G)){
+        int ecc = parallel_bfs(G, src, dist);
+        if(TRACE.enabled) TRACE.record_bfs(G, "bfs", src, dist, ts);
+        LANDMARKS.offer(src, dist);
+        return ecc;
+    }
     dist.assign(G.n, INT_MAX);
     if(!G.weighted){
         queue<int> q;
         dist[src]=0; q.push(src);
         while(!q.empty()){
             int u=q.front(); q.pop();
-            for(auto [_,v,w]: G.adj[u]){
+            for(auto [v,w]: G.adj[u]){
                 if(dist[v]==INT_MAX){
                     dist[v] = dist[u]+1;
                     q.push(v);
@@ -61,16 +89,19 @@ int computeEccentricity(const Graph& G, int src, vector<int>& dist){
         }
     } else {
         using P = pair<double,int>;
-        vector<double> d(G.n,1e30);
-        priority_queue<P,vector<P>,greater<P>> pq;
-        d[src]=0; pq.emplace(0,src);
-        while(!pq.empty()){
-            auto [du,u] = pq.top(); pq.pop();
-            if(du> d[u]) continue;
-            for(auto [_,v,w]: G.adj[u]){
-                if(du + w < d[v]){
-                    d[v] = du + w;
-                    pq.emplace(d[v],v);
+        tvector<double,MEM_DIST> d(G.n,1e30);
+        if(DELTA.enabled) delta_stepping(G, src, d);
+        else {
+            priority_queue<P,tvector<P,MEM_DIST>,greater<P>> pq;
+            d[src]=0; pq.emplace(0,src);
+            while(!pq.empty()){
+                auto [du,u] = pq.top(); pq.pop();
+                if(du> d[u]) continue;
+                for(auto [v,w]: G.adj[u]){
+                    if(du + w < d[v]){
+                        d[v] = du + w;
+                        pq.emplace(d[v],v);
+                    }
                 }
             }
         }
@@ -81,22 +112,94 @@ int computeEccentricity(const Graph& G, int src, vector<int>& dist){
     }
     int ecc=0;
     for(int x: dist) if(x<INT_MAX) ecc = max(ecc,x);
+    if(TRACE.enabled) TRACE.record_bfs(G, G.weighted ? "dijkstra" : "bfs", src, dist, ts);
+    if(!G.weighted) LANDMARKS.offer(src, dist);
     return ecc;
 }
 
+// Candidate roots written by take_kosters/hyperanf (--candidates): lines
+// "vertex,role,last_change" with 0-based vertices and role center or
+// periphery; '#' lines are comments.
+vector<pair<int,string>> load_candidates(const string& path, int n){
+    ifstream in(path);
+    if(!in) throw runtime_error("Cannot open "+path);
+    vector<pair<int,string>> out;
+    string line;
+    while(getline(in, line)){
+        if(line.empty() || line[0] == '#') continue;
+        istringstream iss(line);
+        string v, role;
+        getline(iss, v, ',');
+        getline(iss, role, ',');
+        int id = stoi(v);
+        if(id < 0 || id >= n) throw runtime_error("Candidate vertex out of range in "+path);
+        out.emplace_back(id, role);
+    }
+    return out;
+}
+
 // ——— Selection strategies (§4.4) ———
-enum Strategy { BOUND_DIFF=1, INTERCHANGE=2, REPEATED=3 };
+enum Strategy { BOUND_DIFF=1, INTERCHANGE=2, REPEATED=3, APPROX=4 };
 
-int selectFrom(const vector<bool>& inW,
-               const vector<int>& epsL,
-               const vector<int>& epsU,
-               const vector<int>& lastDist,
+// Per-run selection state. The previous pick (REPEATED) and the INTERCHANGE
+// phase live here instead of in statics, so runs are repeatable and can
+// execute concurrently.
+struct Selector {
+    Strategy strat;
+    int  prev     = -1;
+    bool pickHigh = true;
+    deque<int> queued; // --candidates: tried first, in file order
+    // SumSweep warm-up (--sumsweep k): k sources, the first of highest
+    // degree, then the unused vertex with the largest sum of distances from
+    // the sources so far, i.e. a peripheral one.
+    int sweepLeft = 0;
+    tvector<int64_t,MEM_DIST> sumDist;
+    tvector<bool,MEM_W> swept;
+    bool warm = false; // last pick came from the candidates or the warm-up
+    Selector(Strategy _strat): strat(_strat) {}
+    // Candidate and warm-up picks still to come; pruned candidates are
+    // skipped by selectFrom and so do not count.
+    int warmLeft(const tvector<bool,MEM_W>& inW) const {
+        int left = sweepLeft;
+        for(int v : queued) left += inW[v];
+        return left;
+    }
+};
+
+template<class Graph, class Bound, class LastDist>
+int selectFrom(const tvector<bool,MEM_W>& inW,
+               const Bound& epsL,
+               const Bound& epsU,
+               const LastDist& lastDist,
                const Graph& G,
-               Strategy strat,
-               int prevSelected)
+               Selector& sel)
 {
     int best = -1;
-    switch(strat){
+    sel.warm = true;
+    while(!sel.queued.empty()){
+        int v = sel.queued.front();
+        sel.queued.pop_front();
+        if(inW[v]){
+            sel.prev = v;
+            return v;
+        }
+    }
+    if(sel.sweepLeft > 0){
+        --sel.sweepLeft;
+        int64_t mx = -1;
+        for(int w = 0; w < G.n; w++) if(!sel.swept[w]){
+            int64_t key = sel.prev < 0 ? (int64_t)G.adj[w].size() : sel.sumDist[w];
+            if(key > mx){
+                mx = key;
+                best = w;
+            }
+        }
+        sel.swept[best] = true;
+        sel.prev = best;
+        return best;
+    }
+    sel.warm = false;
+    switch(sel.strat){
       case BOUND_DIFF: {
          int64_t mx = -1;
          for(int w = 0; w < G.n; w++) if(inW[w]){
@@ -109,8 +212,7 @@ int selectFrom(const vector<bool>& inW,
          break;
       }
       case INTERCHANGE: {
-        static bool pickHigh = true;
-        if(pickHigh){
+        if(sel.pickHigh){
           // largest epsU
           int mx = INT_MIN;
           for(int w=0; w<G.n; w++) if(inW[w]){
@@ -127,11 +229,11 @@ int selectFrom(const vector<bool>& inW,
             }
           }
         }
-        pickHigh = !pickHigh;
+        sel.pickHigh = !sel.pickHigh;
         break;
       }
       case REPEATED: {
-        if(prevSelected < 0){
+        if(sel.prev < 0){
           // initial: highest degree
           int mxdeg = -1;
           for(int w=0; w<G.n; w++) if(inW[w]){
@@ -151,79 +253,994 @@ int selectFrom(const vector<bool>& inW,
         }
         break;
       }
+      case APPROX: // approximateDiameter() does not select
+        break;
     }
+    sel.prev = best;
     return best;
 }
 
+// ——— Checkpointing ———
+// The loop serialises its state into a byte buffer every --checkpoint-every
+// seconds and hands it to a writer thread, which writes path.tmp, fsyncs it
+// and renames it over path, so the file on disk is always a complete
+// checkpoint and the loop never waits for the disk. A snapshot taken while
+// the previous one is still being written replaces it in the queue.
+struct ByteWriter {
+    vector<char> buf;
+    template<class T> void put(const T& x){
+        const char* p = (const char*)&x;
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+    template<class V> void put_vec(const V& v){
+        put<uint64_t>(v.size());
+        if constexpr(is_same_v<typename V::value_type, bool>){
+            for(bool x : v) buf.push_back(x);
+        } else {
+            const char* p = (const char*)v.data();
+            buf.insert(buf.end(), p, p + v.size() * sizeof(typename V::value_type));
+        }
+    }
+};
+
+struct ByteReader {
+    vector<char> buf;
+    size_t pos = 0;
+    ByteReader(const string& path){
+        ifstream in(path, ios::binary);
+        if(!in) throw runtime_error("Cannot open "+path);
+        buf.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    void need(size_t k){ if(pos + k > buf.size()) throw runtime_error("Truncated checkpoint"); }
+    template<class T> T get(){
+        need(sizeof(T));
+        T x;
+        memcpy(&x, buf.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return x;
+    }
+    template<class V> void get_vec(V& v){
+        uint64_t k = get<uint64_t>();
+        using T = typename V::value_type;
+        need(k * (is_same_v<T, bool> ? 1 : sizeof(T)));
+        v.resize(k);
+        if constexpr(is_same_v<T, bool>){
+            for(uint64_t i = 0; i < k; ++i) v[i] = buf[pos + i];
+            pos += k;
+        } else {
+            memcpy(v.data(), buf.data() + pos, k * sizeof(T));
+            pos += k * sizeof(T);
+        }
+    }
+};
+
+struct Checkpointer {
+    string path;
+    double every = 60;
+    Clock::time_point last = Clock::now();
+    mutex mu;
+    condition_variable cv;
+    vector<char> queued;
+    bool hasQueued = false, stop = false;
+    thread writer;
+    int written = 0;
+    atomic<int> syncFd{-1}; // file the checkpoint refers to; synced first
+
+    bool enabled() const { return !path.empty(); }
+    void start(){
+        if(enabled()) writer = thread([this]{ loop(); });
+    }
+    bool due() const {
+        return enabled() && chrono::duration<double>(Clock::now() - last).count() >= every;
+    }
+    void submit(vector<char>&& buf){
+        last = Clock::now();
+        lock_guard<mutex> lk(mu);
+        queued = move(buf);
+        hasQueued = true;
+        cv.notify_one();
+    }
+    // Flushes the last queued snapshot and stops the writer.
+    void finish(){
+        if(!writer.joinable()) return;
+        { lock_guard<mutex> lk(mu); stop = true; }
+        cv.notify_one();
+        writer.join();
+    }
+    ~Checkpointer(){ finish(); }
+private:
+    void loop(){
+        unique_lock<mutex> lk(mu);
+        for(;;){
+            cv.wait(lk, [this]{ return hasQueued || stop; });
+            if(!hasQueued) return;
+            vector<char> buf = move(queued);
+            hasQueued = false;
+            lk.unlock();
+            write_atomic(buf);
+            lk.lock();
+        }
+    }
+    void write_atomic(const vector<char>& buf){
+        if(syncFd >= 0) fsync(syncFd);
+        string tmp = path + ".tmp";
+        int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool ok = fd >= 0;
+        for(size_t off = 0; ok && off < buf.size(); ){
+            ssize_t k = ::write(fd, buf.data() + off, buf.size() - off);
+            if(k <= 0) ok = false;
+            else off += k;
+        }
+        ok = ok && fsync(fd) == 0;
+        if(fd >= 0) close(fd);
+        if(ok && rename(tmp.c_str(), path.c_str()) == 0) ++written;
+        else cerr<<"Checkpoint write to "<<path<<" failed\n";
+    }
+};
+Checkpointer CKPT;
+
+// ——— Iteration log ———
+// One int32 record per iteration: iter, |W|, DeltaL, DeltaU, pivots and
+// vertices pruned only thanks to --propagate. Records
+// go to a binary file as they are produced (--log-bin; with --log-every N
+// only every Nth record and the last one), and only the last --log-tail
+// records stay in memory. The text log on stdout is read back from the file
+// at the end, so memory no longer grows with the iteration count. Without
+// --log-bin the file is temporary, or path.log next to a checkpoint so that
+// a resumed run still has the records written before the interruption.
+// File layout: "BDLG", version, columns, every, strategy, 0, then records.
+struct IterRecord { int32_t iter, W, deltaL, deltaU, batch, propagated; };
+const uint32_t ITERLOG_VERSION = 2;
+const long ITERLOG_HEADER = 24;
+
+struct IterLog {
+    string path;
+    int every = 1;
+    size_t tailCap = 1024; // 0: keep every record in memory
+    bool toFile = true;
+    int strategy = 0;
+    FILE* out = nullptr;
+    int64_t seen = 0, written = 0;
+    bool lastWritten = true;
+    IterRecord last{};
+    tvector<IterRecord,MEM_LOG> ring;
+    size_t head = 0; // oldest record once the ring is full
+
+    // A resumed log keeps the first `written` records already in the file.
+    void open(bool resume){
+        if(!resume) reset();
+        if(!toFile) return;
+        if(resume){
+            out = fopen(path.c_str(), "r+b");
+            if(!out) throw runtime_error("Cannot open iteration log "+path);
+            fseek(out, 0, SEEK_END);
+            long keep = ITERLOG_HEADER + written * (long)sizeof(IterRecord);
+            if(ftell(out) < keep) throw runtime_error("Iteration log "+path+" is shorter than the checkpoint");
+            fflush(out);
+            if(ftruncate(fileno(out), keep) != 0) throw runtime_error("Cannot truncate "+path);
+            fseek(out, keep, SEEK_SET);
+            return;
+        }
+        out = path.empty() ? tmpfile() : fopen(path.c_str(), "w+b");
+        if(!out) throw runtime_error("Cannot write iteration log "+path);
+        uint32_t header[6] = {0, ITERLOG_VERSION, 6, (uint32_t)every, (uint32_t)strategy, 0};
+        memcpy(header, "BDLG", 4);
+        fwrite(header, sizeof header, 1, out);
+    }
+    void reset(){
+        seen = written = 0;
+        lastWritten = true;
+        ring.clear();
+        head = 0;
+    }
+    void push(const IterRecord& r){
+        if(tailCap == 0 || ring.size() < tailCap) ring.push_back(r);
+        else {
+            ring[head] = r;
+            head = (head + 1) % tailCap;
+        }
+        last = r;
+        lastWritten = seen++ % every == 0;
+        if(lastWritten && out){
+            fwrite(&r, sizeof r, 1, out);
+            ++written;
+        }
+    }
+    // The last record even if down-sampled away; the ring in order.
+    void finish(){
+        if(!lastWritten && out){
+            fwrite(&last, sizeof last, 1, out);
+            ++written;
+        }
+        lastWritten = true;
+        if(out) fflush(out);
+        rotate(ring.begin(), ring.begin() + head, ring.end());
+        head = 0;
+    }
+    template<class F> void replay(F f){
+        if(!out) return;
+        fseek(out, ITERLOG_HEADER, SEEK_SET);
+        IterRecord r;
+        for(int64_t i = 0; i < written && fread(&r, sizeof r, 1, out) == 1; ++i) f(r);
+    }
+    void close(){
+        if(out) fclose(out);
+        out = nullptr;
+    }
+    // Checkpoints record how much of the file is valid, not the records.
+    void save(ByteWriter& w){
+        if(out) fflush(out);
+        w.put(every); w.put((uint64_t)tailCap); w.put(seen); w.put(written);
+        w.put(lastWritten); w.put(last);
+        w.put_vec(path);
+        tvector<IterRecord,MEM_LOG> ordered;
+        for(size_t i = 0; i < ring.size(); ++i) ordered.push_back(ring[(head + i) % ring.size()]);
+        w.put_vec(ordered);
+    }
+    void load(ByteReader& r){
+        every = r.get<int>(); tailCap = r.get<uint64_t>(); seen = r.get<int64_t>(); written = r.get<int64_t>();
+        lastWritten = r.get<bool>(); last = r.get<IterRecord>();
+        r.get_vec(path);
+        r.get_vec(ring);
+        head = 0;
+    }
+};
+IterLog LOG;
+
 // ——— Instrumented BoundingDiameters (Alg. 1 + §4.4) ———
 struct RunStats {
     int    totalEcc       = 0;
     int    totalPruned    = 0;
     double totalTime      = 0.0;
-    vector<array<double,4>> log; 
-    // each entry: {iter, |W|, ΔL, ΔU}
+    int64_t deltaL = 0, deltaU = 0; // final bounds; deltaL is the diameter
+    // per-vertex eccentricity bounds at the end (keepBounds only)
+    tvector<int,MEM_EPS> eccLower, eccUpper;
+    tvector<IterRecord,MEM_LOG> tail; // last LOG.tailCap iterations, in order
+};
+
+// Per-vertex bounds and the last distance array, stored in the narrowest type
+// B whose maximum (NONE: unknown bound / unreached) is above every stored
+// value. Bounds derived from a source v never exceed 2*ecc(v) < NONE, so
+// uint8 covers eccentricities up to 127 and uint16 up to 32767; wider
+// sources promote the arrays before they are updated.
+template<class B>
+struct Bounds {
+    static constexpr B NONE = numeric_limits<B>::max();
+    tvector<B,MEM_EPS>  epsL, epsU;
+    tvector<B,MEM_DIST> lastDist;
+    Bounds(int n): epsL(n, 0), epsU(n, NONE), lastDist(n, NONE) {}
+    template<class From>
+    Bounds(Bounds<From>& o): epsL(o.epsL.size()), epsU(o.epsU.size()), lastDist(o.lastDist.size()) {
+        auto conv = [](auto& to, auto& from){
+            for(size_t i = 0; i < from.size(); ++i)
+                to[i] = from[i] == Bounds<From>::NONE ? NONE : B(from[i]);
+            from = {};
+            from.shrink_to_fit();
+        };
+        conv(epsL, o.epsL);
+        conv(epsU, o.epsU);
+        conv(lastDist, o.lastDist);
+    }
+    static bool fits(int64_t ecc){ return is_same_v<B,int> || 2 * ecc < NONE; }
+    void save(ByteWriter& w) const { w.put_vec(epsL); w.put_vec(epsU); w.put_vec(lastDist); }
+    void load(ByteReader& r){ r.get_vec(epsL); r.get_vec(epsU); r.get_vec(lastDist); }
 };
 
-RunStats boundingDiametersInstr(const Graph& G, Strategy strat){
-    int n = G.n, Wsize = n, prev = -1;
-    vector<bool> inW(n, true);
-    vector<int> epsL(n, INT_MIN), epsU(n, INT_MAX), lastDist(n), dist;
+// ——— Batched multi-pivot rounds (--batch k) ———
+// A round takes the k best vertices of W under the strategy's own score,
+// skipping neighbours of pivots already taken (they give nearly the same
+// bounds), and runs their BFS on up to --threads workers. Each worker folds
+// its pivot into the shared epsL/epsU/lastDist with CAS min/max as soon as
+// its BFS ends; the folds commute, so the result does not depend on the
+// order the BFS finish in. DeltaL/DeltaU and the pruning of W follow once
+// the whole round is in. lastDist ends up as the distance to the nearest
+// pivot of the round, so REPEATED moves away from all of them.
+//
+// With k = 0 the batch size adapts to measured time. A pivot is wasted when
+// the other pivots of its round alone would have pruned it, i.e. the
+// sequential algorithm would not have spent a BFS on it; the rest are useful.
+// A round is repaid when its wall time is below that of running its useful
+// pivots one after another, useful x t1, where t1 is the BFS time of the
+// last single-pivot round (the first auto round has one pivot, and k = 1
+// rounds probe k = 2 again). An unrepaid round halves k; a round that
+// reaches 3/4 of the ideal k-fold speedup doubles it, up to the thread
+// count; otherwise k stays.
+struct BatchConfig {
+    int k = 1; // 1: the sequential algorithm
+    bool enabled() const { return k != 1; }
+};
+BatchConfig BATCH;
+
+struct Pivot {
+    int v, ecc = 0;
+    DistVec dist;
+    bool merged = false;
+    double seconds = 0; // its BFS
+};
+
+// Both return whether *a changed.
+template<class T> bool atomic_max(T* a, T v){
+    T cur = __atomic_load_n(a, __ATOMIC_RELAXED);
+    while(v > cur)
+        if(__atomic_compare_exchange_n(a, &cur, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return true;
+    return false;
+}
+template<class T> bool atomic_min(T* a, T v){
+    T cur = __atomic_load_n(a, __ATOMIC_RELAXED);
+    while(v < cur)
+        if(__atomic_compare_exchange_n(a, &cur, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return true;
+    return false;
+}
+
+// Loop state that survives a promotion of the bound arrays.
+struct BDState {
+    int Wsize;
     int64_t deltaL = 0, deltaU = INT_MAX;
-    RunStats S;
     int iter = 0;
+    int pendingSrc = -1, pendingEcc = -1; // eccentricity computed, bounds not yet updated
+    Selector sel;
+    tvector<bool,MEM_W> inW;
+    DistVec dist;
+    RunStats S;
+    int batchK = 0;          // --batch: pivots in the next round
+    vector<Pivot> batch;     // current round; kept across a promotion
+    double roundSeconds = 0; // wall time of the current round's BFS
+    double bfsSeconds = 0;   // --batch 0: one uncontended BFS (t1)
+    tvector<char,MEM_W> unreached;
+    bool keepBounds = false;
+    // --propagate worklist; propSlot[v] indexes propOld, v's bounds before
+    // this round's propagation (-1: untouched)
+    vector<int> work;
+    tvector<char,MEM_W> onList;
+    tvector<int,MEM_W> propSlot;
+    vector<array<int,3>> propOld;
+    int propagated = 0; // pruned in the last round only thanks to propagation
+    BDState(int n, Strategy strat): Wsize(n), sel(strat), inW(n, true) {}
+    // Checkpoints are taken between iterations, so no eccentricity is pending
+    // and dist need not be saved.
+    void save(ByteWriter& w) const {
+        w.put(Wsize); w.put(deltaL); w.put(deltaU); w.put(iter);
+        w.put(sel.prev); w.put(sel.pickHigh); w.put(sel.sweepLeft);
+        w.put_vec(vector<int>(sel.queued.begin(), sel.queued.end()));
+        w.put_vec(sel.sumDist); w.put_vec(sel.swept);
+        w.put_vec(inW);
+        w.put(S.totalEcc); w.put(S.totalPruned); w.put(S.totalTime);
+        LOG.save(w);
+        w.put(batchK);
+    }
+    void load(ByteReader& r){
+        Wsize = r.get<int>(); deltaL = r.get<int64_t>(); deltaU = r.get<int64_t>(); iter = r.get<int>();
+        sel.prev = r.get<int>(); sel.pickHigh = r.get<bool>(); sel.sweepLeft = r.get<int>();
+        vector<int> q;
+        r.get_vec(q);
+        sel.queued.assign(q.begin(), q.end());
+        r.get_vec(sel.sumDist); r.get_vec(sel.swept);
+        r.get_vec(inW);
+        S.totalEcc = r.get<int>(); S.totalPruned = r.get<int>(); S.totalTime = r.get<double>();
+        LOG.load(r);
+        batchK = r.get<int>();
+    }
+};
+
+// Checkpoint file: "BDCK", version, n, strategy, sizeof(B), BDState, Bounds<B>.
+const uint32_t BD_CKPT_VERSION = 4;
+
+template<class B>
+vector<char> bd_snapshot(const BDState& st, const Bounds<B>& b){
+    ByteWriter w;
+    w.buf.insert(w.buf.end(), {'B','D','C','K'});
+    w.put(BD_CKPT_VERSION);
+    w.put((int)st.inW.size());
+    w.put((int)st.sel.strat);
+    w.put((int)sizeof(B));
+    st.save(w);
+    b.save(w);
+    return move(w.buf);
+}
+
+// Candidate and warm-up rows count up to -1, so the strategy's own
+// iterations start at 0 however many candidates were pruned before use.
+void logIteration(BDState& st, int pivots){
+    if(st.sel.warm) st.iter = -1 - st.sel.warmLeft(st.inW);
+    LOG.push({st.iter, st.Wsize, int32_t(st.deltaL), int32_t(min<int64_t>(st.deltaU, INT_MAX)),
+              pivots, st.propagated});
+    ++st.iter;
+}
+
+// With --propagate (st.onList allocated), a vertex whose epsL or epsU the
+// fold actually moved is claimed on st.onList and appended to changed, which
+// seeds the propagation pass; the claim keeps concurrent folds from listing
+// it twice.
+template<class B>
+void foldPivot(const Pivot& p, BDState& st, Bounds<B>& b, vector<int>& changed){
+    for(int w = 0; w < (int)p.dist.size(); w++) if(st.inW[w]){
+        int d = p.dist[w];
+        if(d == INT_MAX){
+            __atomic_store_n(&st.unreached[w], 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        bool raised  = atomic_max(&b.epsL[w], B(max(p.ecc - d, d)));
+        bool lowered = atomic_min(&b.epsU[w], B(p.ecc + d));
+        atomic_min(&b.lastDist[w], B(d));
+        if((raised || lowered) && !st.onList.empty() && !__atomic_exchange_n(&st.onList[w], 1, __ATOMIC_RELAXED))
+            changed.push_back(w);
+    }
+}
+
+// ——— Neighbour bound propagation (--propagate) ———
+// Eccentricities of adjacent vertices differ by at most the edge weight, and
+// on unweighted graphs a leaf v hanging off u (deg u >= 2) has exactly
+// ecc(v) = ecc(u) + 1. After a round's BFS bounds are folded in, a worklist
+// pass pushes these relations outward from every vertex whose bounds changed,
+// until nothing changes, and only then is W pruned. Bounds from one BFS
+// already satisfy the edge relation, so the gain comes mostly from the leaf
+// rule (a leaf's lower bound rises by up to 2). A pruned vertex is counted
+// as propagated when its bounds from before the pass would not have pruned it.
+struct PropagateConfig {
+    bool enabled = false;
+};
+PropagateConfig PROPAGATE;
+
+// st.work holds the vertices whose bounds changed; they must be on st.onList.
+template<class B, class Graph>
+void propagateBounds(const Graph& G, BDState& st, Bounds<B>& b){
+    TraceScope trace("propagation");
+    auto& epsL = b.epsL;
+    auto& epsU = b.epsU;
+    auto save = [&](int v){
+        if(st.propSlot[v] >= 0) return;
+        st.propSlot[v] = st.propOld.size();
+        st.propOld.push_back({v, int(epsL[v]), int(epsU[v])});
+    };
+    while(!st.work.empty()){
+        int u = st.work.back();
+        st.work.pop_back();
+        st.onList[u] = 0;
+        for(auto [v, w] : G.adj[u]){
+            int64_t dl = -(int64_t)ceil(w), du = (int64_t)ceil(w);
+            if(!G.weighted){
+                if(G.adj[v].size() == 1 && G.adj[u].size() > 1) dl = du = 1;       // v is u's leaf
+                else if(G.adj[u].size() == 1 && G.adj[v].size() > 1) dl = du = -1; // u is v's leaf
+            }
+            bool changed = false;
+            int64_t low = (int64_t)epsL[u] + dl;
+            if(low > (int64_t)epsL[v]){
+                save(v);
+                epsL[v] = B(low);
+                changed = true;
+            }
+            if(epsU[u] != Bounds<B>::NONE){
+                int64_t high = (int64_t)epsU[u] + du;
+                if(high < (int64_t)epsU[v]){
+                    save(v);
+                    epsU[v] = B(high);
+                    changed = true;
+                }
+            }
+            if(changed && !st.onList[v]){
+                st.onList[v] = 1;
+                st.work.push_back(v);
+            }
+        }
+    }
+}
+
+// Bounds of v before the last propagation pass, or its current ones.
+template<class B>
+pair<int64_t,int64_t> boundsBeforePropagation(const BDState& st, const Bounds<B>& b, int v){
+    int slot = st.propSlot.empty() ? -1 : st.propSlot[v];
+    if(slot < 0) return {b.epsL[v], b.epsU[v]};
+    return {st.propOld[slot][1], st.propOld[slot][2]};
+}
+
+void endPropagation(BDState& st){
+    for(auto& o : st.propOld) st.propSlot[o[0]] = -1;
+    st.propOld.clear();
+}
+
+// Candidates and the SumSweep warm-up still go one vertex per round.
+template<class B, class Graph>
+vector<int> selectBatch(const Graph& G, BDState& st, const Bounds<B>& b, int k){
+    Selector& sel = st.sel;
+    if(!sel.queued.empty() || sel.sweepLeft > 0)
+        return {selectFrom(st.inW, b.epsL, b.epsU, b.lastDist, G, sel)};
+    sel.warm = false;
+    vector<pair<int64_t,int>> cand;
+    cand.reserve(st.Wsize);
+    for(int w = 0; w < G.n; w++) if(st.inW[w]){
+        int64_t key;
+        switch(sel.strat){
+          case BOUND_DIFF:  key = (int64_t)b.epsU[w] - (int64_t)b.epsL[w]; break;
+          case INTERCHANGE: key = sel.pickHigh ? (int64_t)b.epsU[w] : -(int64_t)b.epsL[w]; break;
+          default:          key = sel.prev < 0 ? (int64_t)G.adj[w].size() : (int64_t)b.lastDist[w]; break;
+        }
+        cand.emplace_back(key, w);
+    }
+    if(sel.strat == INTERCHANGE) sel.pickHigh = !sel.pickHigh;
+    // best key first, lowest id among ties as in selectFrom()
+    size_t scan = min(cand.size(), size_t(8) * k);
+    partial_sort(cand.begin(), cand.begin() + scan, cand.end(), [](auto& x, auto& y){
+        return x.first != y.first ? x.first > y.first : x.second < y.second;
+    });
+    vector<int> picks, skipped;
+    unordered_set<int> near;
+    for(size_t i = 0; i < scan && (int)picks.size() < k; ++i){
+        int v = cand[i].second;
+        if(near.count(v)){
+            skipped.push_back(v);
+            continue;
+        }
+        picks.push_back(v);
+        for(auto [u,w] : G.adj[v]) near.insert(u);
+    }
+    for(size_t i = 0; i < skipped.size() && (int)picks.size() < k; ++i) picks.push_back(skipped[i]);
+    sel.prev = picks[0];
+    return picks;
+}
+
+// One batched round. Returns the number of pivots, or -1 if a pivot needs
+// wider bounds; the round is then finished after the promotion.
+template<class B, class Graph>
+int batchRound(const Graph& G, BDState& st, Bounds<B>& b){
+    const int n = G.n;
+    auto& inW = st.inW;
+    if(st.batch.empty()){
+        int k = BATCH.k > 0 ? BATCH.k : max(1, st.batchK);
+        double ts = TRACE.enabled ? TRACE.now() : 0;
+        vector<int> piv = selectBatch(G, st, b, k);
+        if(TRACE.enabled) TRACE.phase("selection", ts, TRACE.now() - ts);
+        st.batch.resize(piv.size());
+        for(size_t i = 0; i < piv.size(); ++i){
+            st.batch[i].v = piv[i];
+            st.batch[i].dist.resize(n);
+        }
+        st.unreached.assign(n, 0);
+        for(int w = 0; w < n; w++) if(inW[w]) b.lastDist[w] = Bounds<B>::NONE;
 
-    while(deltaL < deltaU && Wsize > 0){
-        int v = selectFrom(inW, epsL, epsU, lastDist, G, strat, prev);
-        prev = v;
+        // one sequential BFS per worker, as the pivots are the parallelism
+        long long threshold = PAR_BFS.threshold;
+        int deltaThreads = DELTA.threads;
+        PAR_BFS.threshold = LLONG_MAX;
+        DELTA.threads = 1;
+        atomic<size_t> next{0};
+        const int T = min<int>(st.batch.size(), PAR_BFS.threads);
+        vector<vector<int>> changed(T);
+        auto worker = [&](int t){
+            for(size_t i; (i = next.fetch_add(1)) < st.batch.size(); ){
+                Pivot& p = st.batch[i];
+                auto b0 = Clock::now();
+                p.ecc = computeEccentricity(G, p.v, p.dist);
+                p.seconds = chrono::duration<double>(Clock::now() - b0).count();
+                if(Bounds<B>::fits(p.ecc)){
+                    foldPivot(p, st, b, changed[t]);
+                    p.merged = true;
+                }
+            }
+        };
         auto t0 = Clock::now();
-        int eccv = computeEccentricity(G, v, dist);
-        auto t1 = Clock::now();
-        double dt = chrono::duration<double>(t1 - t0).count();
+        vector<thread> pool;
+        for(int t = 1; t < T; ++t) pool.emplace_back(worker, t);
+        worker(0);
+        for(auto& t : pool) t.join();
+        for(auto& c : changed) st.work.insert(st.work.end(), c.begin(), c.end());
+        st.roundSeconds = chrono::duration<double>(Clock::now() - t0).count();
+        st.S.totalTime += st.roundSeconds;
+        st.S.totalEcc += st.batch.size();
+        PAR_BFS.threshold = threshold;
+        DELTA.threads = deltaThreads;
+        if(st.sel.sweepLeft > 0)
+            for(int w = 0; w < n; w++)
+                if(st.batch[0].dist[w] != INT_MAX) st.sel.sumDist[w] += st.batch[0].dist[w];
+    }
+    for(auto& p : st.batch) if(!p.merged){
+        if(!Bounds<B>::fits(p.ecc)) return -1;
+        foldPivot(p, st, b, st.work);
+        p.merged = true;
+    }
+    for(auto& p : st.batch){
+        st.deltaL = max<int64_t>(st.deltaL, p.ecc);
+        st.deltaU = min<int64_t>(st.deltaU, 2 * (int64_t)p.ecc);
+    }
 
-        S.totalEcc++;
-        S.totalTime += dt;
-        lastDist = dist;
+    if(PROPAGATE.enabled) propagateBounds(G, st, b);
+    TraceScope trace("bound_update");
+    auto prunable = [&](int64_t low, int64_t high){
+        return (high <= st.deltaL && low >= (st.deltaU+1)/2) || low == high;
+    };
+    int before = st.Wsize;
+    st.propagated = 0;
+    for(int w = 0; w < n; w++) if(inW[w]){
+        if(st.unreached[w] || prunable(b.epsL[w], b.epsU[w])){
+            inW[w] = false;
+            --st.Wsize;
+            if(PROPAGATE.enabled && !st.unreached[w]){
+                auto [low, high] = boundsBeforePropagation(st, b, w);
+                if(!prunable(low, high)) ++st.propagated;
+            }
+        }
+    }
+    if(PROPAGATE.enabled) endPropagation(st);
+    st.S.totalPruned += before - st.Wsize;
+    if(TRACE.enabled)
+        TRACE.counter("bounds", "\"W\":" + to_string(st.Wsize)
+                      + ",\"DeltaL\":" + to_string(st.deltaL)
+                      + ",\"DeltaU\":" + to_string(st.deltaU));
+
+    int pivots = st.batch.size();
+    if(BATCH.k == 0){
+        if(pivots == 1){
+            st.bfsSeconds = st.batch[0].seconds;
+            st.batchK = min(PAR_BFS.threads, 2); // probe again
+        } else if(st.bfsSeconds == 0){
+            st.batchK = 1; // resumed run: measure t1 first
+        } else {
+            int wasted = 0;
+            for(auto& p : st.batch){
+                int64_t low = 0, high = INT64_MAX;
+                bool cut = false;
+                for(auto& q : st.batch) if(&q != &p){
+                    int d = q.dist[p.v];
+                    if(d == INT_MAX){ cut = true; break; }
+                    low  = max<int64_t>(low, max(q.ecc - d, d));
+                    high = min<int64_t>(high, q.ecc + d);
+                }
+                if(cut || low == high || (high <= st.deltaL && low >= (st.deltaU+1)/2)) ++wasted;
+            }
+            // speedup over running the useful pivots one after another
+            double speedup = (pivots - wasted) * st.bfsSeconds / max(st.roundSeconds, 1e-9);
+            if(speedup < 1)                    st.batchK = max(1, pivots / 2);
+            else if(4 * speedup >= 3 * pivots) st.batchK = min(PAR_BFS.threads, 2 * pivots);
+            else                               st.batchK = pivots;
+        }
+    }
+    st.batch.clear();
+    return pivots;
+}
+
+// Runs BoundingDiameters on bounds of type B until it finishes (true) or a
+// source's eccentricity needs wider bounds (false; its BFS is kept in st).
+template<class B, class Graph>
+bool boundingDiametersLoop(const Graph& G, BDState& st, Bounds<B>& b){
+    const int n = G.n;
+    auto& inW = st.inW;
+    auto& dist = st.dist;
+    auto& epsL = b.epsL;
+    auto& epsU = b.epsU;
+    auto& S = st.S;
+    while(st.deltaL < st.deltaU && st.Wsize > 0){
+        if(BATCH.enabled()){
+            int pivots = batchRound(G, st, b);
+            if(pivots < 0) return false;
+            logIteration(st, pivots);
+            if(CKPT.due()) CKPT.submit(bd_snapshot(st, b));
+            continue;
+        }
+        int eccv;
+        if(st.pendingEcc >= 0){
+            eccv = st.pendingEcc;
+            st.pendingEcc = -1;
+        } else {
+            double ts = TRACE.enabled ? TRACE.now() : 0;
+            int v = selectFrom(inW, epsL, epsU, b.lastDist, G, st.sel);
+            if(TRACE.enabled) TRACE.phase("selection", ts, TRACE.now() - ts);
+            auto t0 = Clock::now();
+            eccv = computeEccentricity(G, v, dist);
+            auto t1 = Clock::now();
+            double dt = chrono::duration<double>(t1 - t0).count();
+
+            S.totalEcc++;
+            S.totalTime += dt;
+            if(st.sel.sweepLeft > 0) // sums feed the next warm-up pick
+                for(int w=0; w<n; w++)
+                    if(dist[w] != INT_MAX) st.sel.sumDist[w] += dist[w];
+        }
+        if(!Bounds<B>::fits(eccv)){
+            st.pendingEcc = eccv;
+            return false;
+        }
 
         // update global bounds
-        deltaL = max<int64_t>(deltaL, eccv);
-        deltaU = min<int64_t>(deltaU, 2 * (int64_t)eccv);
+        st.deltaL = max<int64_t>(st.deltaL, eccv);
+        st.deltaU = min<int64_t>(st.deltaU, 2 * (int64_t)eccv);
 
-        // update per-node bounds and prune
-        int before = Wsize;
+        // update per-node bounds and prune; lastDist is only read for
+        // vertices still in W, so it is refreshed here rather than copied
+        TraceScope trace("bound_update");
+        int before = st.Wsize;
+        st.propagated = 0;
         for(int w=0; w<n; w++) if(inW[w]){
             int dvw = dist[w];
+            if(dvw == INT_MAX){ // other component: no bound applies, drop it
+                inW[w] = false;
+                --st.Wsize;
+                continue;
+            }
+            b.lastDist[w] = dvw;
             int low  = max(eccv - dvw, dvw);
             int high = eccv + dvw;
-            epsL[w] = max(epsL[w], low);
-            epsU[w] = min(epsU[w], high);
-            if((epsU[w] <= deltaL && epsL[w] >= (deltaU+1)/2)
+            if(PROPAGATE.enabled && (low > epsL[w] || high < epsU[w]) && !st.onList[w]){
+                st.onList[w] = 1;
+                st.work.push_back(w);
+            }
+            epsL[w] = max<int>(epsL[w], low);
+            epsU[w] = min<int>(epsU[w], high);
+            if(PROPAGATE.enabled) continue; // pruned after propagation
+            if((epsU[w] <= st.deltaL && epsL[w] >= (st.deltaU+1)/2)
                || epsL[w] == epsU[w])
             {
                 inW[w] = false;
-                --Wsize;
+                --st.Wsize;
             }
         }
-        S.totalPruned += (before - Wsize);
+        if(PROPAGATE.enabled){
+            propagateBounds(G, st, b);
+            auto prunable = [&](int64_t low, int64_t high){
+                return (high <= st.deltaL && low >= (st.deltaU+1)/2) || low == high;
+            };
+            for(int w=0; w<n; w++) if(inW[w] && prunable(epsL[w], epsU[w])){
+                inW[w] = false;
+                --st.Wsize;
+                auto [low, high] = boundsBeforePropagation(st, b, w);
+                if(!prunable(low, high)) ++st.propagated;
+            }
+            endPropagation(st);
+        }
+        S.totalPruned += (before - st.Wsize);
+        if(TRACE.enabled)
+            TRACE.counter("bounds", "\"W\":" + to_string(st.Wsize)
+                          + ",\"DeltaL\":" + to_string(st.deltaL)
+                          + ",\"DeltaU\":" + to_string(st.deltaU));
+
+        logIteration(st, 1);
+        if(CKPT.due()) CKPT.submit(bd_snapshot(st, b));
+    }
+    return true;
+}
+
+// Runs the loop from bounds of type B, promoting to the next width whenever
+// the loop asks for it.
+template<class B, class Graph>
+void boundingDiametersFrom(const Graph& G, BDState& st, Bounds<B>& b){
+    if(boundingDiametersLoop(G, st, b)){
+        if(CKPT.enabled()) CKPT.submit(bd_snapshot(st, b));
+        if(st.keepBounds){
+            auto widen = [](auto& to, const auto& from){
+                to.resize(from.size());
+                for(size_t i = 0; i < from.size(); ++i)
+                    to[i] = from[i] == Bounds<B>::NONE ? INT_MAX : int(from[i]);
+            };
+            widen(st.S.eccLower, b.epsL);
+            widen(st.S.eccUpper, b.epsU);
+        }
+        return;
+    }
+    if constexpr(is_same_v<B,uint8_t>){
+        Bounds<uint16_t> wide(b);
+        boundingDiametersFrom(G, st, wide);
+    } else if constexpr(is_same_v<B,uint16_t>){
+        Bounds<int> wide(b);
+        boundingDiametersFrom(G, st, wide);
+    }
+}
 
-        // log iteration state
-        S.log.push_back({double(iter),
-                         double(Wsize),
-                         double(deltaL),
-                         double(deltaU)});
-        ++iter;
+// Candidate vertices (centres first, as they give the tightest DeltaU, then
+// peripheral ones for DeltaL) are selected before the strategy takes over,
+// followed by the SumSweep warm-up. Warm-up iterations are logged with
+// negative numbers -k..-1 so the strategy's own iterations still start at 0.
+// A resumed run restores the whole loop state from the checkpoint instead,
+// at the bound width it had reached.
+template<class Graph>
+RunStats boundingDiametersInstr(const Graph& G, Strategy strat,
+                                const vector<int>& candidates = {}, int sumSweeps = 0,
+                                const string& resumePath = "", bool keepBounds = false){
+    BDState st(G.n, strat);
+    st.keepBounds = keepBounds;
+    if(PROPAGATE.enabled){
+        st.onList.assign(G.n, 0);
+        st.propSlot.assign(G.n, -1);
     }
+    if(!resumePath.empty()){
+        ByteReader r(resumePath);
+        r.need(4);
+        if(memcmp(r.buf.data(), "BDCK", 4) != 0) throw runtime_error("Not a BoundingDiameters checkpoint");
+        r.pos = 4;
+        if(r.get<uint32_t>() != BD_CKPT_VERSION) throw runtime_error("Unsupported checkpoint version");
+        if(r.get<int>() != G.n) throw runtime_error("Checkpoint was written for a different graph");
+        if(r.get<int>() != (int)strat) throw runtime_error("Checkpoint was written for a different strategy");
+        int width = r.get<int>();
+        st.load(r);
+        LOG.open(true);
+        CKPT.syncFd = LOG.out ? fileno(LOG.out) : -1;
+        if(width == 1){
+            Bounds<uint8_t> b(0);
+            b.load(r);
+            boundingDiametersFrom(G, st, b);
+        } else if(width == 2){
+            Bounds<uint16_t> b(0);
+            b.load(r);
+            boundingDiametersFrom(G, st, b);
+        } else {
+            Bounds<int> b(0);
+            b.load(r);
+            boundingDiametersFrom(G, st, b);
+        }
+    } else {
+        st.sel.queued.assign(candidates.begin(), candidates.end());
+        if(sumSweeps > 0){
+            st.sel.sweepLeft = min(sumSweeps, G.n);
+            st.sel.sumDist.assign(G.n, 0);
+            st.sel.swept.assign(G.n, false);
+        }
+        LOG.strategy = strat;
+        LOG.open(false);
+        CKPT.syncFd = LOG.out ? fileno(LOG.out) : -1;
+        Bounds<uint8_t> b8(G.n);
+        boundingDiametersFrom(G, st, b8);
+    }
+    st.sel.sumDist = {};
+    st.sel.sumDist.shrink_to_fit();
+    st.S.deltaL = st.deltaL;
+    st.S.deltaU = st.deltaU;
+    LOG.finish();
+    st.S.tail = move(LOG.ring);
+    LOG.ring.clear();
+    return move(st.S);
+}
+
+// ——— 3/2-approximation (strategy 4) ———
+// Roditty–Vassilevska Williams, for graphs where |W| never collapses: BFS
+// from k = ceil(sqrt(n ln n)) random vertices S (--samples, --seed), then
+// from the vertex w farthest from S, then from the k vertices closest to w.
+// The runs of each phase share the --threads workers like a --batch round.
+// DeltaL is the largest eccentricity seen, so it is exact as a lower bound.
+// DeltaU is 2 * the smallest eccentricity seen. The floor(2D/3) guarantee,
+// and with it D <= (3 DeltaL + 2)/2 on unweighted graphs, holds when S hits
+// the k-ball of w, i.e. every vertex closer to w than d(w,S) was a source.
+// That holds w.h.p. and is checked after the run: only then is DeltaU
+// lowered to the 3/2 bound, so DeltaU is always certified. One log record
+// per phase: |W| is the number of BFS still planned, Batch the runs of the
+// phase.
+struct ApproxConfig {
+    uint32_t seed = 1;
+    int samples = 0; // 0: ceil(sqrt(n ln n))
+    // set by the last run
+    int  reach = 0, radius = 0; // d(w,S); distance of the farthest ball vertex
+    bool hit = false;           // the ball covers every vertex closer than reach
+    bool ran = false;
+
+    void report(ostream& out) const {
+        if(!ran) return;
+        out << "# approx: d(w,S)=" << reach << " ball_radius=" << radius
+            << " hit=" << (hit ? "yes" : "no") << "\n";
+    }
+};
+ApproxConfig APPROXIMATION;
+
+template<class Graph>
+RunStats approximateDiameter(const Graph& G, bool keepBounds = false){
+    const int n = G.n;
+    RunStats S;
+    int64_t lb = 0, ub = INT64_MAX;
+    int iter = 0;
+    int k = APPROXIMATION.samples > 0 ? APPROXIMATION.samples
+          : (int)ceil(sqrt(n * max(1.0, log((double)n))));
+    k = min(k, n);
+    tvector<int,MEM_DIST> nearS(n, INT_MAX); // distance to the closest sample
+    if(keepBounds){
+        S.eccLower.assign(n, 0);
+        S.eccUpper.assign(n, INT_MAX);
+    }
+    LOG.strategy = APPROX;
+    LOG.open(false);
+
+    auto fold = [&](int ecc, const DistVec& dist, bool sample){
+        for(int v = 0; v < n; ++v){
+            int d = dist[v];
+            if(d == INT_MAX) continue;
+            if(sample) atomic_min(&nearS[v], d);
+            if(keepBounds){
+                atomic_max(&S.eccLower[v], max(ecc - d, d));
+                atomic_min(&S.eccUpper[v], ecc + d);
+            }
+        }
+    };
+    auto account = [&](const vector<int>& eccs, double seconds){
+        for(int e : eccs){
+            lb = max<int64_t>(lb, e);
+            ub = min<int64_t>(ub, 2 * (int64_t)e);
+        }
+        S.totalEcc += eccs.size();
+        S.totalTime += seconds;
+    };
+    auto logPhase = [&](int planned, int runs){
+        LOG.push({iter++, planned, int32_t(lb), int32_t(min<int64_t>(ub, INT_MAX)), runs, 0});
+    };
+    // one sequential BFS per worker, as in batchRound
+    auto runAll = [&](const vector<int>& srcs, bool sample){
+        vector<int> eccs(srcs.size());
+        long long threshold = PAR_BFS.threshold;
+        int deltaThreads = DELTA.threads;
+        PAR_BFS.threshold = LLONG_MAX;
+        DELTA.threads = 1;
+        atomic<size_t> next{0};
+        auto worker = [&]{
+            DistVec dist;
+            for(size_t i; (i = next.fetch_add(1)) < srcs.size(); ){
+                eccs[i] = computeEccentricity(G, srcs[i], dist);
+                fold(eccs[i], dist, sample);
+            }
+        };
+        auto t0 = Clock::now();
+        vector<thread> pool;
+        for(int t = 1; t < min<int>(srcs.size(), PAR_BFS.threads); ++t) pool.emplace_back(worker);
+        worker();
+        for(auto& t : pool) t.join();
+        PAR_BFS.threshold = threshold;
+        DELTA.threads = deltaThreads;
+        account(eccs, chrono::duration<double>(Clock::now() - t0).count());
+    };
+
+    mt19937 rng(APPROXIMATION.seed);
+    vector<int> sample(n);
+    iota(sample.begin(), sample.end(), 0);
+    for(int i = 0; i < k; ++i) swap(sample[i], sample[i + rng() % (n - i)]);
+    sample.resize(k);
+    runAll(sample, true);
+    logPhase(k + 1, k);
+
+    // farthest from S; vertices S does not reach are skipped, as in computeEccentricity
+    int w = sample[0];
+    for(int v = 0; v < n; ++v)
+        if(nearS[v] != INT_MAX && nearS[v] > nearS[w]) w = v;
+    const int reach = nearS[w];
+    nearS = {};
+    nearS.shrink_to_fit();
+    DistVec dist;
+    auto t0 = Clock::now();
+    int eccW = computeEccentricity(G, w, dist);
+    fold(eccW, dist, false);
+    account({eccW}, chrono::duration<double>(Clock::now() - t0).count());
+    logPhase(k, 1);
+
+    // the k vertices closest to w, ties to the lower id
+    vector<pair<int,int>> byDist;
+    for(int v = 0; v < n; ++v) if(v != w && dist[v] != INT_MAX) byDist.emplace_back(dist[v], v);
+    size_t m = min<size_t>(k, byDist.size());
+    nth_element(byDist.begin(), byDist.begin() + m, byDist.end());
+    vector<int> ball;
+    int radius = 0;
+    for(size_t i = 0; i < m; ++i){
+        ball.push_back(byDist[i].second);
+        radius = max(radius, byDist[i].first);
+    }
+    // byDist is ordered by distance up to position m, so every vertex closer
+    // than radius is in the ball; with the whole component taken all are
+    bool hit = m == byDist.size() || radius >= reach;
+    dist = {};
+    runAll(ball, false);
+    if(!G.weighted && hit) ub = min<int64_t>(ub, (3 * lb + 2) / 2);
+    logPhase(0, ball.size());
+    APPROXIMATION.reach = reach;
+    APPROXIMATION.radius = radius;
+    APPROXIMATION.hit = hit;
+    APPROXIMATION.ran = true;
+
+    S.deltaL = lb;
+    S.deltaU = ub;
+    LOG.finish();
+    S.tail = move(LOG.ring);
+    LOG.ring.clear();
     return S;
 }
 
 // ——— main() ———
-int main(int argc, char* argv[]){
-    if(argc < 4){
-        cerr<<"Usage: "<<argv[0]
-            <<" --strategy [1|2|3] graph.mtx\n";
-        return 1;
-    }
-    Strategy strat = Strategy(stoi(argv[2]));
-    Graph G = load_mm_graph(argv[3]);
+template<class Graph>
+int run(const Graph& G, const string& path, Strategy strat, const string& tracePath,
+        const string& candidatesPath, int sumSweeps, const string& resumePath){
+    copy(MEM, MEM + MEM_CATS, MEM_LOAD);
+    MEM_LOAD_TOTAL = MEM_TOTAL;
+    mem_reset_peaks();
+    if(DELTA.enabled && DELTA.delta <= 0) DELTA.delta = auto_delta(G);
 
     // compute |E| as sum of adjacency lengths
     int64_t edgeCount = 0;
@@ -235,14 +1252,25 @@ int main(int argc, char* argv[]){
           "EccCalls,PrunedNodes,TotalTime(s),Memory(KB)\n";
 
     // run the algorithm
-    RunStats R = boundingDiametersInstr(G, strat);
+    vector<int> candidates;
+    if(!candidatesPath.empty())
+        for(auto& [v, role] : load_candidates(candidatesPath, G.n)) candidates.push_back(v);
+    if(LOG.path.empty() && CKPT.enabled()) LOG.path = CKPT.path + ".log";
+    if(strat == APPROX && (CKPT.enabled() || !resumePath.empty()))
+        throw runtime_error("--checkpoint/--resume apply to strategies 1-3");
+    if(LANDMARKS.enabled() && G.weighted)
+        throw runtime_error("--landmarks needs an unweighted graph");
+    CKPT.start();
+    RunStats R = strat == APPROX ? approximateDiameter(G)
+               : boundingDiametersInstr(G, strat, candidates, sumSweeps, resumePath);
+    CKPT.finish();
     // get peak memory usage (in KB)
     struct rusage usage;
     getrusage(RUSAGE_SELF, & usage);
     long memKB = usage.ru_maxrss;
 
     // Table 1 row
-    cout<<argv[3]<<","
+    cout<<path<<","
         <<G.n<<","
         <<edgeCount<<","
         <<avgDeg<<","
@@ -253,13 +1281,170 @@ int main(int argc, char* argv[]){
         <<memKB<<"\n\n";
 
     // Figure 2 header + data
-    cout<<"# iter,|W|,DeltaL,DeltaU\n";
-    for(auto &e : R.log){
-        cout<<int(e[0])<<","
-            <<int(e[1])<<","
-            <<int(e[2])<<","
-            <<int(e[3])<<"\n";
+    bool batchColumn = BATCH.enabled() || strat == APPROX;
+    cout<<"# iter,|W|,DeltaL,DeltaU"<<(batchColumn ? ",Batch" : "")
+        <<(PROPAGATE.enabled ? ",Propagated" : "")<<"\n";
+    LOG.replay([&](const IterRecord& e){
+        cout<<e.iter<<","
+            <<e.W<<","
+            <<e.deltaL<<","
+            <<e.deltaU;
+        if(batchColumn) cout<<","<<e.batch;
+        if(PROPAGATE.enabled) cout<<","<<e.propagated;
+        cout<<"\n";
+    });
+    LOG.close();
+
+    if(LANDMARKS.enabled()){
+        LANDMARKS.write(G.n);
+        cerr<<"# landmarks: "<<LANDMARKS.kept.size()<<" written to "<<LANDMARKS.path<<"\n";
     }
+    BUILD.report(cerr);
+    APPROXIMATION.report(cerr);
+    cerr<<"# phase,structure,live_bytes,peak_bytes\n";
+    mem_print(cerr, "load", MEM_LOAD, MEM_LOAD_TOTAL);
+    mem_print(cerr, "run", MEM, MEM_TOTAL);
 
+    if(TRACE.enabled){
+        TRACE.write_json(tracePath);
+        TRACE.print_summary(cerr);
+    }
     return 0;
 }
+
+#ifdef DIAMETER_LIB
+// ——— C API for diameter.py (-DDIAMETER_LIB -shared -fPIC) ———
+// The graph stays loaded between calls, and the whole iteration log is kept
+// in memory instead of a log file. Result arrays are owned by the result
+// handle and exposed to Python without copying; they stay valid until
+// bd_free_result. Errors return null/-1 and set bd_error().
+// Calls into the library are serialised, since the run configuration is global.
+using AnyGraph = variant<monostate, BasicGraph<void>, BasicGraph<uint32_t>,
+                         BasicGraph<float>, BasicGraph<double>>;
+struct BdGraph { AnyGraph g; int n = 0; int64_t arcs = 0; bool weighted = false; };
+mutex API_MU;
+thread_local string API_ERROR;
+
+extern "C" {
+const char* bd_error(){ return API_ERROR.c_str(); }
+
+void* bd_load(const char* path){
+    lock_guard<mutex> lk(API_MU);
+    try {
+        auto* h = new BdGraph;
+        with_graph(path, [&](auto&& G){
+            h->n = G.n;
+            h->weighted = G.weighted;
+            for(auto& nbr : G.adj) h->arcs += nbr.size();
+            h->g = move(G);
+            return 0;
+        });
+        return h;
+    } catch(const exception& e){
+        API_ERROR = e.what();
+        return nullptr;
+    }
+}
+void bd_free_graph(void* g){ delete (BdGraph*)g; }
+int bd_vertices(void* g){ return ((BdGraph*)g)->n; }
+long long bd_arcs(void* g){ return ((BdGraph*)g)->arcs; }
+int bd_weighted(void* g){ return ((BdGraph*)g)->weighted; }
+
+// batch, threads and propagate as --batch, --threads and --propagate;
+// threads <= 0 keeps the default. The settings apply to this call only.
+void* bd_run(void* g, int strategy, int sumSweeps, int batch, int threads, int propagate){
+    lock_guard<mutex> lk(API_MU);
+    struct Restore {
+        ParBfsConfig par = PAR_BFS;
+        DeltaConfig delta = DELTA;
+        BatchConfig batch = BATCH;
+        PropagateConfig propagate = PROPAGATE;
+        ~Restore(){ PAR_BFS = par; DELTA = delta; BATCH = batch; PROPAGATE = propagate; }
+    } restore;
+    try {
+        if(strategy < BOUND_DIFF || strategy > APPROX) throw runtime_error("Invalid strategy");
+        BATCH.k = max(0, batch);
+        PROPAGATE.enabled = propagate != 0;
+        LOG.toFile = false;
+        LOG.tailCap = 0;
+        if(threads > 0) PAR_BFS.threads = DELTA.threads = threads;
+        auto* R = new RunStats;
+        visit([&](auto& G){
+            if constexpr(!is_same_v<decay_t<decltype(G)>, monostate>)
+                *R = strategy == APPROX ? approximateDiameter(G, true)
+                   : boundingDiametersInstr(G, Strategy(strategy), {}, sumSweeps, "", true);
+        }, ((BdGraph*)g)->g);
+        return R;
+    } catch(const exception& e){
+        API_ERROR = e.what();
+        return nullptr;
+    }
+}
+void bd_free_result(void* r){ delete (RunStats*)r; }
+long long bd_diameter(void* r){ return ((RunStats*)r)->deltaL; }
+long long bd_upper_bound(void* r){ return ((RunStats*)r)->deltaU; }
+int bd_ecc_calls(void* r){ return ((RunStats*)r)->totalEcc; }
+int bd_pruned(void* r){ return ((RunStats*)r)->totalPruned; }
+double bd_time(void* r){ return ((RunStats*)r)->totalTime; }
+// rows x 6 int32: iter, |W|, DeltaL, DeltaU, pivots, propagated
+const IterRecord* bd_log(void* r, long long* rows){
+    auto& log = ((RunStats*)r)->tail;
+    *rows = log.size();
+    return log.data();
+}
+// n ints each; INT_MAX where no upper bound is known
+const int* bd_ecc_lower(void* r){ return ((RunStats*)r)->eccLower.data(); }
+const int* bd_ecc_upper(void* r){ return ((RunStats*)r)->eccUpper.data(); }
+}
+#else
+int main(int argc, char* argv[]){
+    if(argc < 4){
+        cerr<<"Usage: "<<argv[0]
+            <<" --strategy [1|2|3|4] graph.mtx [--trace trace.json]"
+              " [--threads T] [--par-bfs min_vertices] [--sssp dijkstra|delta] [--delta D]"
+              " [--candidates hyperanf.csv] [--sumsweep k]"
+              " [--checkpoint file [--checkpoint-every seconds]] [--resume file]"
+              " [--batch k (0 = auto)] [--log-bin file] [--log-every N] [--log-tail N]"
+              " [--samples k] [--seed S] [--landmarks file [--landmark-count k]]"
+              " [--propagate 0|1]\n";
+        return 1;
+    }
+    string tracePath, candidatesPath, resumePath;
+    int sumSweeps = 0;
+    for(int i = 4; i + 1 < argc; i += 2){
+        string flag = argv[i];
+        if(flag == "--trace") tracePath = argv[i+1];
+        else if(flag == "--threads") PAR_BFS.threads = DELTA.threads = BUILD.threads = max(1, stoi(argv[i+1]));
+        else if(flag == "--sssp") DELTA.enabled = string(argv[i+1]) == "delta";
+        else if(flag == "--delta"){
+            DELTA.delta = stod(argv[i+1]);
+            if(!(DELTA.delta > 0)){ cerr<<"--delta must be positive\n"; return 1; }
+        }
+        else if(flag == "--par-bfs") PAR_BFS.threshold = stoll(argv[i+1]);
+        else if(flag == "--candidates") candidatesPath = argv[i+1];
+        else if(flag == "--sumsweep") sumSweeps = max(0, stoi(argv[i+1]));
+        else if(flag == "--checkpoint") CKPT.path = argv[i+1];
+        else if(flag == "--checkpoint-every") CKPT.every = max(0.0, stod(argv[i+1]));
+        else if(flag == "--resume") resumePath = argv[i+1];
+        else if(flag == "--batch") BATCH.k = max(0, stoi(argv[i+1]));
+        else if(flag == "--log-bin") LOG.path = argv[i+1];
+        else if(flag == "--log-every") LOG.every = max(1, stoi(argv[i+1]));
+        else if(flag == "--log-tail") LOG.tailCap = max(1, stoi(argv[i+1]));
+        else if(flag == "--samples") APPROXIMATION.samples = max(1, stoi(argv[i+1]));
+        else if(flag == "--seed") APPROXIMATION.seed = stoul(argv[i+1]);
+        else if(flag == "--landmarks") LANDMARKS.path = argv[i+1];
+        else if(flag == "--landmark-count") LANDMARKS.k = max(1, stoi(argv[i+1]));
+        else if(flag == "--propagate") PROPAGATE.enabled = stoi(argv[i+1]) != 0;
+        else { cerr<<"Unknown option "<<flag<<"\n"; return 1; }
+    }
+    TRACE.enabled = !tracePath.empty();
+
+    Strategy strat = Strategy(stoi(argv[2]));
+    string path = argv[3];
+    double ts = TRACE.now();
+    return with_graph(path, [&](const auto& G){
+        if(TRACE.enabled) TRACE.phase("load", ts, TRACE.now() - ts);
+        return run(G, path, strat, tracePath, candidatesPath, sumSweeps, resumePath);
+    });
+}
+#endif